@@ -16,6 +16,9 @@ namespace cppbm::examples::decorator
     class BasicLoggerDecorator<Target> : public FunctionDecorator<Target>
     {
     public:
+        using FunctionDecorator<Target>::BeforeCall;
+        using FunctionDecorator<Target>::AfterCall;
+
         bool BeforeCall(Args&... /*args*/) override
         {
             std::printf("[basic.before] ");
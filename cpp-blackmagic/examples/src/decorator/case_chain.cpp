@@ -16,6 +16,9 @@ namespace cppbm::examples::decorator
     class FirstChainDecorator<Target> : public FunctionDecorator<Target>
     {
     public:
+        using FunctionDecorator<Target>::BeforeCall;
+        using FunctionDecorator<Target>::AfterCall;
+
         bool BeforeCall(Args&... /*args*/) override
         {
             std::printf("[first.before] ");
@@ -35,6 +38,9 @@ namespace cppbm::examples::decorator
     class SecondChainDecorator<Target> : public FunctionDecorator<Target>
     {
     public:
+        using FunctionDecorator<Target>::BeforeCall;
+        using FunctionDecorator<Target>::AfterCall;
+
         bool BeforeCall(Args&... /*args*/) override
         {
             std::printf("[second.before] ");
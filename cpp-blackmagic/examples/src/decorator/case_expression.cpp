@@ -20,6 +20,9 @@ namespace cppbm::examples::decorator
     class RouteDecorator<Target> : public FunctionDecorator<Target>
     {
     public:
+        using FunctionDecorator<Target>::BeforeCall;
+        using FunctionDecorator<Target>::AfterCall;
+
         bool BeforeCall(Args&... /*args*/) override
         {
             std::printf("[route.before] ");
@@ -16,6 +16,9 @@ namespace cppbm::examples::decorator
     class MemberTraceDecorator<Target> : public FunctionDecorator<Target>
     {
     public:
+        using FunctionDecorator<Target>::BeforeCall;
+        using FunctionDecorator<Target>::AfterCall;
+
         bool BeforeCall(C*& /*thiz*/, Args&... /*args*/) override
         {
             std::printf("[member.before] ");
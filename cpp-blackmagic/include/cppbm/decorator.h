@@ -5,8 +5,13 @@
 #include <tuple>
 #include <type_traits>
 
+#include "internal/hook/batch.h"
 #include "internal/hook/error.h"
+#include "internal/hook/expand.h"
 #include "internal/hook/hook.h"
+#include "internal/hook/quiesce.h"
+#include "internal/hook/static_chain.h"
+#include "internal/hook/symbol.h"
 #include "internal/utils/noncopyable.h"
 
 namespace cpp::blackmagic
@@ -76,7 +81,11 @@ namespace cpp::blackmagic
 
         FunctionDecorator()
         {
-            (void)this->RegisterDecoratorNode();
+            // Members of a static chain are registered by the chain instead.
+            if (!hook::StaticChainMembers::Claim(&this->GetPipeline()))
+            {
+                (void)this->RegisterDecoratorNode();
+            }
         }
 
         ~FunctionDecorator()
@@ -85,6 +94,94 @@ namespace cpp::blackmagic
         }
     };
 
+    // Runtime bypass of every decorator on Target, without unregistering them:
+    //   SetDecoratorBypass<&Foo>(true);   // Foo runs its original code, unhooked
+    //   SetDecoratorBypass<&Foo>(false);  // decorators active again
+    // Returns false when the hook backend could not switch (see hook::HookError).
+    template <auto Target>
+        requires decorator::DecoratorTarget<Target>
+    bool SetDecoratorBypass(bool bypass)
+    {
+        return detail::Decorator<Target, decltype(Target)>::GetPipeline().SetBypass(bypass);
+    }
+
+    template <auto Target>
+        requires decorator::DecoratorTarget<Target>
+    bool IsDecoratorBypassed()
+    {
+        return detail::Decorator<Target, decltype(Target)>::GetPipeline().IsBypassed();
+    }
+
+    // Lazy install (SetHookInstallMode(HookInstallMode::Lazy), or build with
+    // CPPBM_HOOK_LAZY_INSTALL): decorators on Target are only recorded until
+    //   ActivateDecorator<&Foo>();   // patch Foo now (and on later registrations)
+    // Returns false when the hook backend could not install (see hook::HookError).
+    template <auto Target>
+        requires decorator::DecoratorTarget<Target>
+    bool ActivateDecorator()
+    {
+        return detail::Decorator<Target, decltype(Target)>::GetPipeline().Activate();
+    }
+
+    // Idle / Registered (recorded, not patched) / Installed / Bypassed.
+    template <auto Target>
+        requires decorator::DecoratorTarget<Target>
+    hook::HookPipelineState GetDecoratorState()
+    {
+        return detail::Decorator<Target, decltype(Target)>::GetPipeline().State();
+    }
+
+    // Decorator on a target named at runtime, e.g. a function of a plugin
+    // that is dlopen()ed later (see hook/symbol.h):
+    //   class Timing : public SymbolDecorator<int(int)>
+    //   {
+    //   public:
+    //       Timing() : SymbolDecorator("libplugin.so", "PluginWork") {}
+    //   };
+    // Registered at once; installed when the library is (or gets) loaded.
+    template <typename Fn>
+        requires std::is_function_v<Fn>
+    class SymbolDecorator : public hook::SymbolHookBase<Fn>
+    {
+    public:
+        SymbolDecorator(const char* library, const char* symbol)
+            : hook::SymbolHookBase<Fn>(library, symbol)
+        {
+            (void)this->RegisterDecoratorNode();
+        }
+
+        ~SymbolDecorator()
+        {
+            this->UnregisterDecoratorNode();
+        }
+    };
+
+    using hook::RescanSymbolTargets;
+
+    using hook::HookInstallMode;
+    using hook::HookPipelineState;
+    using hook::SetHookInstallMode;
+    using hook::GetHookInstallMode;
+
+    // Live patching of a running process (see hook/quiesce.h):
+    //   SetLivePatchMode(LivePatchMode::StopTheWorld);
+    //   ... install / bypass decorators while threads run ...
+    //   GetLivePatchStats().max_pause_ns;
+    using hook::LivePatchMode;
+    using hook::LivePatchStats;
+    using hook::SetLivePatchMode;
+    using hook::GetLivePatchMode;
+    using hook::GetLivePatchStats;
+
+    // Batched install: decorators registered between Begin and Commit are
+    // patched in one backend pass, all or none (see hook/batch.h).
+    //   BeginHookBatch();
+    //   ... construct decorators / bindings ...
+    //   CommitHookBatch();
+    using hook::BeginHookBatch;
+    using hook::CommitHookBatch;
+    using hook::InstallAll;
+
     // Decorator binding, to maintain decorator object lifetime.
     template <auto Target, template<auto> class DecoratorT>
     class DecoratorBinding : private utils::NonCopyable
@@ -97,6 +194,48 @@ namespace cpp::blackmagic
         DecoratorT<Target> decorator_{};
     };
 
+    // Compile-time description of one decorator in a static chain.
+    // Returned by Binder::BindStatic<&Target>(...) after metadata is applied.
+    template <typename DecoratorT>
+    struct StaticDecoratorSpec
+    {
+        using Decorator = DecoratorT;
+    };
+
+    // Static chain binding: every decorator of one Target fused into a single
+    // pipeline node (see internal/hook/static_chain.h).
+    template <auto Target, typename... Decorators>
+    class StaticDecoratorBinding : private utils::NonCopyable
+    {
+    public:
+        using HookBase = detail::Decorator<Target, decltype(Target)>;
+        using Node = typename HookBase::Pipeline::Node;
+
+        static_assert(
+            (hook::StaticNodeCall<Node>::template BindsStatically<Decorators>() && ...),
+            "BindStaticChain: a decorator overrides BeforeCall(args...) or AfterCall(result) "
+            "but hides the CallContext overload, so the fused chain would reach it through "
+            "two virtual calls; add `using FunctionDecorator<Target>::BeforeCall;` and "
+            "`using FunctionDecorator<Target>::AfterCall;` to the decorator.");
+
+        StaticDecoratorBinding() = default;
+        ~StaticDecoratorBinding() = default;
+
+    private:
+        hook::StaticChainNode<HookBase, Node, Decorators...> chain_{};
+    };
+
+    // Static chain entry point emitted by decorator.py in static-chain mode:
+    //   inline auto reg = BindStaticChain<&Foo>(
+    //       (logger).BindStatic<&Foo>(),
+    //       (inject).BindStatic<&Foo>(metas...));
+    template <auto Target, typename... Decorators>
+        requires decorator::DecoratorTarget<Target>
+    auto BindStaticChain(StaticDecoratorSpec<Decorators>...)
+    {
+        return StaticDecoratorBinding<Target, Decorators...>{};
+    }
+
     // Decorator binder, to be used like:
     //   inline auto reg = logger.Bind<&Foo>();
     template <template<auto> class DecoratorT>
@@ -111,6 +250,14 @@ namespace cpp::blackmagic
             // metadata they understand.
             return DecoratorBinding<Target, DecoratorT>{};
         }
+
+        // Static-chain counterpart of Bind: same metadata contract, but only
+        // names the decorator type; BindStaticChain owns the instance.
+        template <auto Target, typename... Metas>
+        auto BindStatic(Metas&&...) const
+        {
+            return StaticDecoratorSpec<DecoratorT<Target>>{};
+        }
     };
 }
 
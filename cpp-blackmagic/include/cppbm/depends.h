@@ -292,7 +292,8 @@ namespace cpp::blackmagic
     }
 
     // Remove one explicit injected value by exact key in current active context.
-    inline bool RemoveDependencyAt(const void* target, const void* factory, std::type_index type)
+    // type is depends::TypeKeyOf<T>() of the injected value type.
+    inline bool RemoveDependencyAt(const void* target, const void* factory, depends::TypeKey type)
     {
         if (!depends::HasBoundInjectState())
         {
@@ -4,6 +4,7 @@
 // Responsibilities:
 // - consume generated InjectArgMeta<...> objects at Bind<&Target>(...)
 // - choose sync/async metadata registration by target return type
+// - compile the per-target injection plan (plan.h) from the same metadata
 // - expose default binder object `inject`
 
 #ifndef __CPPBM_DEPENDS_COMPILE_INJECT_H__
@@ -16,6 +17,7 @@
 #include <utility>
 
 #include "meta.h"
+#include "plan.h"
 #include "../runtime/inject.h"
 
 namespace cpp::blackmagic::depends
@@ -25,15 +27,17 @@ namespace cpp::blackmagic::depends
     // Generated code shape:
     //   InjectArgMeta<Index, Param>([] { return Depends(...); })
     //
-    // This object stores sync/async metadata registration closures.
-    // InjectBinder::Bind decides which one to invoke according to target
-    // return type (Task-returning function => async metadata).
+    // This object stores sync/async metadata registration closures and the
+    // plan compiler for the same default expression.
+    // InjectBinder::Bind decides which registration to invoke according to
+    // target return type (Task-returning function => async metadata).
     template <std::size_t Index, typename Param>
     class InjectArgMeta
     {
     public:
         static constexpr std::size_t kIndex = Index;
         using ParamType = Param;
+        using PlanType = InjectArgPlan<DependsRawFromParamT<Param>>;
 
         InjectArgMeta() = delete;
 
@@ -54,6 +58,10 @@ namespace cpp::blackmagic::depends
                     return MakeDefaultArgMetadataAsync<Param>((*holder)());
                     });
             };
+
+            compile_plan_ = [holder](PlanType& plan, bool async_target) {
+                CompileInjectArgPlan<Param>(plan, holder, async_target);
+            };
         }
 
         bool RegisterSyncAt(const void* target) const
@@ -68,9 +76,15 @@ namespace cpp::blackmagic::depends
             return register_async_at_(target);
         }
 
+        void CompilePlan(PlanType& plan, bool async_target) const
+        {
+            if (compile_plan_) compile_plan_(plan, async_target);
+        }
+
     private:
         std::function<bool(const void*)> register_sync_at_{};
         std::function<bool(const void*)> register_async_at_{};
+        std::function<void(PlanType&, bool)> compile_plan_{};
     };
 
     template <typename T>
@@ -114,6 +128,12 @@ namespace cpp::blackmagic::depends::detail
         constexpr bool kUseAsyncMetadata =
             IsTaskReturn<typename FnTraits::ReturnType>::value;
 
+        // Call-path plan first; the registry metadata below stays registered
+        // for third-party lookups and for parameters the plan does not cover.
+        meta.CompilePlan(
+            g_inject_arg_plan<Target, Index, DependsRawFromParamT<Param>>,
+            kUseAsyncMetadata);
+
         if constexpr (kUseAsyncMetadata)
         {
             return meta.RegisterAsyncAt(TargetKeyOf<Target>());
@@ -150,6 +170,17 @@ namespace cpp::blackmagic
     
             return Base::template Bind<Target>();
         }
+
+        template <auto Target, typename... Metas>
+        auto BindStatic(Metas&&... metas) const
+        {
+            const bool applied_all = (
+                depends::detail::ApplyMeta<Target>(std::forward<Metas>(metas)) && ...
+            );
+            (void)applied_all;
+
+            return Base::template BindStatic<Target>();
+        }
     };
 
     // Default binder object used by preprocess-generated code:
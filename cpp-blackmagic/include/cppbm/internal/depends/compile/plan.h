@@ -0,0 +1,143 @@
+// File role:
+// Per-target injection plan compiled at InjectBinder::Bind.
+//
+// Registry metadata (registry.h) is looked up by (target,index,type) and
+// produced through std::function<std::any()> on every call. The plan keeps,
+// for each Depends(...) parameter of one target:
+// - strategy: plain Depends() placeholder or Depends(factory)
+// - factory key and cached flag, computed once
+// - a typed producer that runs the factory and returns Raw*
+// so a steady-state @inject call resolves without touching the registry.
+
+#ifndef __CPPBM_DEPENDS_COMPILE_PLAN_H__
+#define __CPPBM_DEPENDS_COMPILE_PLAN_H__
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "meta.h"
+
+namespace cpp::blackmagic::depends
+{
+    enum class InjectArgStrategy : unsigned char
+    {
+        // Not compiled: resolve through registry metadata.
+        None,
+        // Depends() / Depends(false): resolve from slot/override/default flow.
+        Placeholder,
+        // Depends(factory): run producer, then cache with owned/borrowed policy.
+        Factory,
+    };
+
+    // Compiled plan for one parameter whose dependency raw type is Raw.
+    // Immutable once published; a later Bind publishes a fresh entry.
+    template <typename Raw>
+    struct InjectArgPlanEntry
+    {
+        InjectArgStrategy strategy = InjectArgStrategy::None;
+        const void* factory = nullptr;
+        bool cached = true;
+        bool owned = false;
+        Raw* (*produce)(void* state) = nullptr;
+        // Producer state: a process-lifetime copy of the generated factory
+        // holder (never released, like registry metadata).
+        void* state = nullptr;
+    };
+
+    // Plan slot for one parameter: the entry compiled by the latest Bind,
+    // or nullptr when that Bind compiled none. Entries are published with
+    // release and read with acquire; replaced entries are kept alive, since
+    // a call may still be reading one (same policy as DefaultArgRegistry).
+    //
+    // Literal type on purpose: plans are constant-initialized, so a Bind
+    // running during another TU's dynamic initialization can never be
+    // overwritten by the plan's own initializer afterwards.
+    template <typename Raw>
+    struct InjectArgPlan
+    {
+        std::atomic<const InjectArgPlanEntry<Raw>*> entry{ nullptr };
+    };
+
+    // One plan slot per (Target, parameter Index, Raw).
+    template <auto Target, std::size_t Index, typename Raw>
+    constinit inline InjectArgPlan<Raw> g_inject_arg_plan{};
+
+    // Compiled plan entry for parameter type Param, or nullptr when Bind did
+    // not compile one (non Depends(...) metadata, value parameter, ...).
+    template <auto Target, std::size_t Index, typename Param>
+    const InjectArgPlanEntry<DependsRawFromParamT<Param>>* FindInjectArgPlan()
+    {
+        if constexpr (std::is_pointer_v<Param> || std::is_reference_v<Param>)
+        {
+            return g_inject_arg_plan<Target, Index, DependsRawFromParamT<Param>>
+                .entry.load(std::memory_order_acquire);
+        }
+        else
+        {
+            return nullptr;
+        }
+    }
+
+    // Typed producer for Depends(factory): same conversion as
+    // MakeDependsPtrValue, without the factory-key lookup.
+    template <typename Raw, typename Factory>
+    Raw* ProduceDependsPtr(void* state)
+    {
+        auto maker = (**static_cast<std::shared_ptr<Factory>*>(state))();
+        decltype(auto) produced = InvokeFactory(maker.factory);
+        return ConvertFactoryResult<Raw*>(std::forward<decltype(produced)>(produced));
+    }
+
+    // Compile one plan entry from a generated default-expression factory.
+    // Evaluates the expression once (builds the DependsMaker; never runs the
+    // dependency factory itself). Async targets keep task-like factories on
+    // the registry path, where their result is awaited instead of Get().
+    // Every Bind recompiles: a re-Bind with other metadata replaces the
+    // entry, or clears it when the new metadata does not compile.
+    template <typename Param, typename Factory>
+    void CompileInjectArgPlan(
+        InjectArgPlan<DependsRawFromParamT<Param>>& plan,
+        const std::shared_ptr<Factory>& holder,
+        bool async_target)
+    {
+        using E = RemoveCvRefT<decltype(std::declval<Factory&>()())>;
+        using Raw = DependsRawFromParamT<Param>;
+
+        if constexpr (std::is_pointer_v<Param> || std::is_reference_v<Param>)
+        {
+            std::unique_ptr<InjectArgPlanEntry<Raw>> next{};
+
+            if constexpr (IsDependsFactoryMaker<E>::value)
+            {
+                using FactoryReturn = decltype(std::declval<E&>().factory());
+                const bool awaited = async_target && GettableValue<std::remove_reference_t<FactoryReturn>>;
+                E maker = awaited ? E{} : (*holder)();
+                if (maker.factory != nullptr)
+                {
+                    next = std::make_unique<InjectArgPlanEntry<Raw>>();
+                    next->strategy = InjectArgStrategy::Factory;
+                    next->factory = FactoryKeyOf(maker.factory);
+                    next->cached = maker.cached;
+                    next->owned = IsDependsFactoryMaker<E>::kFactoryReturnsPointer;
+                    next->produce = &ProduceDependsPtr<Raw, Factory>;
+                    next->state = new std::shared_ptr<Factory>(holder);
+                }
+            }
+            else if constexpr (IsDependsMaker<E>::value)
+            {
+                E maker = (*holder)();
+                next = std::make_unique<InjectArgPlanEntry<Raw>>();
+                next->strategy = InjectArgStrategy::Placeholder;
+                next->cached = maker.cached;
+            }
+
+            // Intentionally leaked with the entry it replaces (see InjectArgPlan).
+            (void)plan.entry.exchange(next.release(), std::memory_order_acq_rel);
+        }
+    }
+}
+
+#endif // __CPPBM_DEPENDS_COMPILE_PLAN_H__
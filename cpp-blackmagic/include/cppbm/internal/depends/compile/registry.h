@@ -21,7 +21,6 @@
 #include <optional>
 #include <shared_mutex>
 #include <type_traits>
-#include <typeindex>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -46,15 +45,76 @@ namespace cpp::blackmagic::depends
     };
 
     // Erased callable for default-arg metadata table.
+    // Kept for binders that register type-erased metadata themselves;
+    // InjectRegistry registers typed factories (below) as well.
     using ErasedFactory = std::function<std::any()>;
 
+    // Typed metadata factory: produces U directly from a state object owned
+    // by the registry entry, without std::function or std::any.
+    template <typename U>
+    using TypedFactoryFn = U(*)(void* state);
+
+    namespace detail
+    {
+        template <typename T>
+        struct TypeKeyToken
+        {
+            static inline char token = 0;
+        };
+    }
+
+    // Type identity used in every DI key: the address of one static char per
+    // type (cv/ref stripped, as typeid does). Comparing and hashing it is a
+    // pointer operation, where std::type_index hashes the mangled name on
+    // GCC/Clang. std::type_index is kept for InjectError diagnostics only.
+    //
+    // Only TypeKeyOf<T>() makes one, so a target or factory key passed where
+    // a type key belongs does not compile.
+    class TypeKey
+    {
+    public:
+        constexpr TypeKey() noexcept = default;
+
+        [[nodiscard]] constexpr const void* Address() const noexcept
+        {
+            return token_;
+        }
+
+        friend constexpr bool operator==(TypeKey, TypeKey) noexcept = default;
+
+    private:
+        template <typename T>
+        friend constexpr TypeKey TypeKeyOf() noexcept;
+
+        constexpr explicit TypeKey(const void* token) noexcept
+            : token_(token)
+        {
+        }
+
+        const void* token_ = nullptr;
+    };
+
+    template <typename T>
+    constexpr TypeKey TypeKeyOf() noexcept
+    {
+        return TypeKey{ &detail::TypeKeyToken<std::remove_cvref_t<T>>::token };
+    }
+
+    struct TypeKeyHash
+    {
+        std::size_t operator()(TypeKey key) const noexcept
+        {
+            return std::hash<const void*>{}(key.Address());
+        }
+    };
+
     // Key used by runtime context-scoped explicit overrides.
     // target == nullptr means context-wide fallback value.
     struct ExplicitValueKey
     {
         const void* target = nullptr;
         const void* factory = nullptr;
-        std::type_index type = typeid(void);
+        TypeKey type{};
 
         bool operator==(const ExplicitValueKey& rhs) const
         {
@@ -70,7 +130,7 @@ namespace cpp::blackmagic::depends
         {
             const auto h1 = std::hash<const void*>{}(key.target);
             const auto h2 = std::hash<const void*>{}(key.factory);
-            const auto h3 = std::hash<std::type_index>{}(key.type);
+            const auto h3 = TypeKeyHash{}(key.type);
             return h1 ^ (h2 << 1) ^ (h3 << 2);
         }
     };
@@ -81,7 +141,7 @@ namespace cpp::blackmagic::depends
     {
         const void* target = nullptr;
         std::size_t index = 0;
-        std::type_index type = typeid(void);
+        TypeKey type{};
 
         bool operator==(const DefaultArgKey& rhs) const
         {
@@ -95,67 +155,218 @@ namespace cpp::blackmagic::depends
         {
             const auto h1 = std::hash<const void*>{}(key.target);
             const auto h2 = std::hash<std::size_t>{}(key.index);
-            const auto h3 = std::hash<std::type_index>{}(key.type);
+            const auto h3 = TypeKeyHash{}(key.type);
             return h1 ^ (h2 << 1) ^ (h3 << 2);
         }
     };
 
     // Default-argument metadata registry:
     // one metadata factory per (target,index,type) key.
+    //
+    // Registration happens during static initialization (Bind), lookups on
+    // every call from any thread. The table is open-addressed with atomic
+    // slots, so Find is a lock-free probe that returns a raw pointer:
+    // - entries are never freed while the registry lives, so the pointer
+    //   stays valid; re-registering a key publishes a new entry in the slot
+    // - writers (serialized by write_mtx_) fill empty slots with a release
+    //   store; when the load factor would pass 1/2, a table twice as large
+    //   is built and published, and the old one is retired, not freed
     class DefaultArgRegistry
     {
     public:
-        using StoredFactory = std::shared_ptr<const ErasedFactory>;
-        using Table = std::unordered_map<DefaultArgKey, StoredFactory, DefaultArgKeyHash>;
-        using SnapshotStorage = std::shared_ptr<const Table>;
+        struct Entry
+        {
+            DefaultArgKey key{};
+            std::size_t hash = 0;
+            ErasedFactory factory{};
+            // TypedFactoryFn<U> for U == key.type (function pointers
+            // round-trip through any function pointer type), or nullptr for
+            // erased-only registrations.
+            void (*typed)() = nullptr;
+            void* typed_state = nullptr;
+            std::shared_ptr<void> typed_owner{};
+        };
 
         DefaultArgRegistry()
         {
-            StoreSnapshot(std::make_shared<const Table>());
+            tables_.push_back(std::make_unique<Table>(kInitialCapacity));
+            table_.store(tables_.back().get(), std::memory_order_release);
         }
 
-        bool Register(const void* target, std::size_t index, std::type_index type, ErasedFactory factory)
+        // type: TypeKeyOf<U>() of the metadata type.
+        bool Register(const void* target, std::size_t index, TypeKey type, ErasedFactory factory)
         {
-            auto stored = std::make_shared<const ErasedFactory>(std::move(factory));
-            std::lock_guard<std::mutex> lock{ write_mtx_ };
-            auto base = LoadSnapshot();
-            auto next = std::make_shared<Table>(base ? *base : Table{});
-            (*next)[DefaultArgKey{ target, index, type }] = std::move(stored);
-            StoreSnapshot(std::static_pointer_cast<const Table>(next));
-            return true;
+            auto entry = std::make_unique<Entry>();
+            entry->key = DefaultArgKey{ target, index, type };
+            entry->factory = std::move(factory);
+            return Publish(std::move(entry));
+        }
+
+        // Typed registration: fn(state) is called on lookup; erased is the
+        // same factory behind std::any for Find() callers.
+        template <typename U>
+        bool RegisterTyped(
+            const void* target,
+            std::size_t index,
+            TypedFactoryFn<U> fn,
+            std::shared_ptr<void> state,
+            ErasedFactory erased)
+        {
+            auto entry = std::make_unique<Entry>();
+            entry->key = DefaultArgKey{ target, index, TypeKeyOf<U>() };
+            entry->factory = std::move(erased);
+            entry->typed = reinterpret_cast<void (*)()>(fn);
+            entry->typed_state = state.get();
+            entry->typed_owner = std::move(state);
+            return Publish(std::move(entry));
+        }
+
+        [[nodiscard]] const ErasedFactory* Find(
+            const void* target,
+            std::size_t index,
+            TypeKey type) const
+        {
+            const Entry* entry = FindEntry(target, index, type);
+            return entry != nullptr ? &entry->factory : nullptr;
         }
 
-        [[nodiscard]] std::optional<StoredFactory> Find(
+        [[nodiscard]] const Entry* FindEntry(
             const void* target,
             std::size_t index,
-            std::type_index type) const
+            TypeKey type) const
+        {
+            const DefaultArgKey key{ target, index, type };
+            return table_.load(std::memory_order_acquire)->Find(
+                key,
+                MixHash(DefaultArgKeyHash{}(key)));
+        }
+
+    private:
+        static constexpr std::size_t kInitialCapacity = 64;
+
+        bool Publish(std::unique_ptr<Entry> entry)
         {
-            auto snapshot = LoadSnapshot();
-            if (!snapshot)
+            entry->hash = MixHash(DefaultArgKeyHash{}(entry->key));
+
+            std::lock_guard<std::mutex> lock{ write_mtx_ };
+            Table* table = table_.load(std::memory_order_relaxed);
+            if (!table->Replace(entry.get()))
             {
-                return std::nullopt;
+                if ((count_ + 1) * 2 > table->Capacity())
+                {
+                    table = Grow(*table);
+                }
+                table->Insert(entry.get());
+                ++count_;
             }
-            auto it = snapshot->find(DefaultArgKey{ target, index, type });
-            if (it == snapshot->end())
+            entries_.push_back(std::move(entry));
+            return true;
+        }
+
+        class Table
+        {
+        public:
+            explicit Table(std::size_t capacity)
+                : mask_(capacity - 1),
+                slots_(std::make_unique<std::atomic<const Entry*>[]>(capacity))
             {
-                return std::nullopt;
             }
-            return it->second;
-        }
 
-    private:
-        std::shared_ptr<const Table> LoadSnapshot() const
+            std::size_t Capacity() const
+            {
+                return mask_ + 1;
+            }
+
+            const Entry* Find(const DefaultArgKey& key, std::size_t hash) const
+            {
+                for (std::size_t i = hash & mask_;; i = (i + 1) & mask_)
+                {
+                    const Entry* entry = slots_[i].load(std::memory_order_acquire);
+                    if (entry == nullptr)
+                    {
+                        return nullptr;
+                    }
+                    if (entry->hash == hash && entry->key == key)
+                    {
+                        return entry;
+                    }
+                }
+            }
+
+            // Writer side (write_mtx_ held).
+            bool Replace(const Entry* next)
+            {
+                for (std::size_t i = next->hash & mask_;; i = (i + 1) & mask_)
+                {
+                    const Entry* entry = slots_[i].load(std::memory_order_relaxed);
+                    if (entry == nullptr)
+                    {
+                        return false;
+                    }
+                    if (entry->hash == next->hash && entry->key == next->key)
+                    {
+                        slots_[i].store(next, std::memory_order_release);
+                        return true;
+                    }
+                }
+            }
+
+            void Insert(const Entry* next)
+            {
+                std::size_t i = next->hash & mask_;
+                while (slots_[i].load(std::memory_order_relaxed) != nullptr)
+                {
+                    i = (i + 1) & mask_;
+                }
+                slots_[i].store(next, std::memory_order_release);
+            }
+
+            template <typename Fn>
+            void ForEach(Fn&& fn) const
+            {
+                for (std::size_t i = 0; i <= mask_; ++i)
+                {
+                    if (const Entry* entry = slots_[i].load(std::memory_order_relaxed))
+                    {
+                        fn(entry);
+                    }
+                }
+            }
+
+        private:
+            std::size_t mask_ = 0;
+            std::unique_ptr<std::atomic<const Entry*>[]> slots_{};
+        };
+
+        // Key hashes combine pointers whose low bits are mostly zero;
+        // spread them before masking.
+        static std::size_t MixHash(std::size_t h)
         {
-            return std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ull;
+            h ^= h >> 33;
+            return h;
         }
 
-        void StoreSnapshot(std::shared_ptr<const Table> next)
+        Table* Grow(const Table& current)
         {
-            std::atomic_store_explicit(&snapshot_, std::move(next), std::memory_order_release);
+            auto next = std::make_unique<Table>(current.Capacity() * 2);
+            current.ForEach([&](const Entry* entry) { next->Insert(entry); });
+            tables_.push_back(std::move(next));
+            Table* published = tables_.back().get();
+            table_.store(published, std::memory_order_release);
+            return published;
         }
 
         mutable std::mutex write_mtx_{};
-        SnapshotStorage snapshot_{};
+        std::atomic<Table*> table_{ nullptr };
+        std::size_t count_ = 0;
+        // Every table and entry ever published; readers may still hold any of
+        // them, so they are released only with the registry.
+        std::vector<std::unique_ptr<Table>> tables_{};
+        std::vector<std::unique_ptr<Entry>> entries_{};
     };
 
     inline DefaultArgRegistry& GetDefaultArgRegistry()
@@ -243,10 +454,10 @@ namespace cpp::blackmagic::depends
         return AnyTo<U>(std::addressof(value));
     }
 
-    inline std::optional<DefaultArgRegistry::StoredFactory> FindDefaultArgFactory(
+    inline const ErasedFactory* FindDefaultArgFactory(
         const void* target,
         std::size_t index,
-        std::type_index type)
+        TypeKey type)
     {
         // Exact-key lookup only; no global fallback here.
         return GetDefaultArgRegistry().Find(target, index, type);
@@ -257,10 +468,13 @@ namespace cpp::blackmagic::depends
     // Why not reinterpret_cast function pointer to void*:
     // - conversion from function pointer to object pointer is not portable.
     // - instead we hash stable byte representation + function-pointer type.
+    // Bytes are stored inline so a lookup does not allocate.
     struct FactoryIdentityKey
     {
-        std::type_index signature = typeid(void);
-        std::vector<unsigned char> bytes{};
+        static constexpr std::size_t kMaxBytes = sizeof(void (*)());
+
+        TypeKey signature{};
+        std::array<unsigned char, kMaxBytes> bytes{};
 
         bool operator==(const FactoryIdentityKey& rhs) const
         {
@@ -272,7 +486,7 @@ namespace cpp::blackmagic::depends
     {
         std::size_t operator()(const FactoryIdentityKey& key) const
         {
-            std::size_t h = std::hash<std::type_index>{}(key.signature);
+            std::size_t h = TypeKeyHash{}(key.signature);
             for (unsigned char b : key.bytes)
             {
                 h ^= static_cast<std::size_t>(b) + 0x9e3779b9u + (h << 6) + (h >> 2);
@@ -285,11 +499,16 @@ namespace cpp::blackmagic::depends
     {
     public:
         const void* GetOrCreate(
-            std::type_index signature,
+            TypeKey signature,
             const unsigned char* bytes,
             std::size_t size)
         {
-            FactoryIdentityKey key{ signature, std::vector<unsigned char>(bytes, bytes + size) };
+            if (size > FactoryIdentityKey::kMaxBytes)
+            {
+                return nullptr;
+            }
+            FactoryIdentityKey key{ signature };
+            std::memcpy(key.bytes.data(), bytes, size);
 
             {
                 std::shared_lock<std::shared_mutex> read_lock{ mtx_ };
@@ -335,9 +554,11 @@ namespace cpp::blackmagic::depends
             return nullptr;
         }
 
+        static_assert(sizeof(factory) <= FactoryIdentityKey::kMaxBytes,
+            "FactoryKeyOf: function pointer wider than FactoryIdentityKey storage.");
         std::array<unsigned char, sizeof(factory)> bytes{};
         std::memcpy(bytes.data(), &factory, bytes.size());
-        return GetFactoryKeyRegistry().GetOrCreate(typeid(R(*)()), bytes.data(), bytes.size());
+        return GetFactoryKeyRegistry().GetOrCreate(TypeKeyOf<R(*)()>(), bytes.data(), bytes.size());
     }
 
     template <auto Target>
@@ -347,6 +568,12 @@ namespace cpp::blackmagic::depends
         return &token;
     }
 
+    template <typename U, typename Factory>
+    U InvokeTypedFactory(void* state)
+    {
+        return static_cast<U>((*static_cast<Factory*>(state))());
+    }
+
     struct InjectRegistry
     {
         // Register generated metadata factory for a runtime-resolved target key.
@@ -366,8 +593,11 @@ namespace cpp::blackmagic::depends
             static_assert(!std::is_reference_v<U>,
                 "InjectRegistry::RegisterAt requires non-reference value type.");
 
-            ErasedFactory erased = [fac = std::forward<Factory>(factory)]() mutable -> std::any {
-                U produced = static_cast<U>(fac());
+            using FactoryT = std::remove_cvref_t<Factory>;
+            auto holder = std::make_shared<FactoryT>(std::forward<Factory>(factory));
+
+            ErasedFactory erased = [holder]() -> std::any {
+                U produced = static_cast<U>((*holder)());
                 if constexpr (std::is_copy_constructible_v<U>)
                 {
                     return std::any(std::move(produced));
@@ -380,10 +610,11 @@ namespace cpp::blackmagic::depends
                 }
                 };
 
-            return GetDefaultArgRegistry().Register(
+            return GetDefaultArgRegistry().RegisterTyped<U>(
                 target,
                 Index,
-                typeid(U),
+                &InvokeTypedFactory<U, FactoryT>,
+                std::move(holder),
                 std::move(erased));
         }
 
@@ -410,12 +641,19 @@ namespace cpp::blackmagic::depends
         template <typename U>
         static std::optional<U> Resolve(const void* target, std::size_t index)
         {
-            auto erased = FindDefaultArgFactory(target, index, typeid(U));
-            if (!erased)
+            const auto* entry = GetDefaultArgRegistry().FindEntry(target, index, TypeKeyOf<U>());
+            if (entry == nullptr)
             {
                 return std::nullopt;
             }
-            auto value = (*(*erased))();
+            // Typed channel: U is produced in place, no allocation.
+            if (entry->typed != nullptr)
+            {
+                return std::optional<U>(
+                    reinterpret_cast<TypedFactoryFn<U>>(entry->typed)(entry->typed_state));
+            }
+            // Erased-only registration (third-party binder).
+            auto value = entry->factory();
             return AnyTo<U>(std::move(value));
         }
     };
@@ -13,8 +13,8 @@
 #include <cassert>
 #include <algorithm>
 #include <any>
+#include <array>
 #include <memory>
-#include <typeindex>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -40,7 +40,7 @@ namespace cpp::blackmagic::depends
     struct SlotKey
     {
         // Canonical object type key for slot identity.
-        std::type_index type = typeid(void);
+        TypeKey type{};
 
         // Optional factory key associated with this resolved value.
         // nullptr means plain Depends() without explicit factory.
@@ -56,19 +56,145 @@ namespace cpp::blackmagic::depends
     {
         std::size_t operator()(const SlotKey& key) const
         {
-            const auto h1 = std::hash<std::type_index>{}(key.type);
+            const auto h1 = TypeKeyHash{}(key.type);
             const auto h2 = std::hash<const void*>{}(key.factory);
             return h1 ^ (h2 << 1);
         }
     };
 
+    // Slot table of one InjectContext.
+    //
+    // A context usually holds one to four dependencies, and every nested
+    // @inject call creates one. The first kInlineSlots entries live inline
+    // and are found by a linear scan on the precomputed key hash; a fifth
+    // entry spills the table to one heap hash map (kept across Clear()).
+    // Slot pointers stay valid until the next Upsert or Clear.
+    class ContextSlotMap
+    {
+    public:
+        static constexpr std::size_t kInlineSlots = 4;
+
+        ContextSlotMap() = default;
+
+        ContextSlotMap(const ContextSlotMap&) = delete;
+        ContextSlotMap& operator=(const ContextSlotMap&) = delete;
+
+        ContextSlotMap(ContextSlotMap&& rhs) noexcept
+            : inline_(std::move(rhs.inline_)),
+            size_(rhs.size_),
+            spilled_(rhs.spilled_),
+            spill_(std::move(rhs.spill_))
+        {
+            rhs.size_ = 0;
+            rhs.spilled_ = false;
+        }
+
+        ContextSlotMap& operator=(ContextSlotMap&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                inline_ = std::move(rhs.inline_);
+                size_ = rhs.size_;
+                spilled_ = rhs.spilled_;
+                spill_ = std::move(rhs.spill_);
+                rhs.size_ = 0;
+                rhs.spilled_ = false;
+            }
+            return *this;
+        }
+
+        [[nodiscard]] ContextSlot* Find(const SlotKey& key, std::size_t hash)
+        {
+            if (spilled_)
+            {
+                const auto it = spill_->find(key);
+                return it != spill_->end() ? &it->second : nullptr;
+            }
+            for (std::size_t i = 0; i < size_; ++i)
+            {
+                if (inline_[i].hash == hash && inline_[i].key == key)
+                {
+                    return &inline_[i].slot;
+                }
+            }
+            return nullptr;
+        }
+
+        // Existing slot for key, or a new empty one.
+        ContextSlot& Upsert(const SlotKey& key, std::size_t hash)
+        {
+            if (auto* existing = Find(key, hash))
+            {
+                return *existing;
+            }
+            if (spilled_)
+            {
+                return (*spill_)[key];
+            }
+            if (size_ < kInlineSlots)
+            {
+                Entry& entry = inline_[size_++];
+                entry.key = key;
+                entry.hash = hash;
+                return entry.slot;
+            }
+
+            if (!spill_)
+            {
+                spill_ = std::make_unique<SpillTable>();
+            }
+            for (std::size_t i = 0; i < size_; ++i)
+            {
+                spill_->emplace(inline_[i].key, std::move(inline_[i].slot));
+                inline_[i].slot = ContextSlot{};
+            }
+            size_ = 0;
+            spilled_ = true;
+            return (*spill_)[key];
+        }
+
+        void Clear()
+        {
+            for (std::size_t i = 0; i < size_; ++i)
+            {
+                inline_[i].slot = ContextSlot{};
+            }
+            size_ = 0;
+            if (spill_)
+            {
+                spill_->clear();
+            }
+            spilled_ = false;
+        }
+
+        [[nodiscard]] std::size_t Size() const
+        {
+            return spilled_ ? spill_->size() : size_;
+        }
+
+    private:
+        struct Entry
+        {
+            SlotKey key{};
+            std::size_t hash = 0;
+            ContextSlot slot{};
+        };
+
+        using SpillTable = std::unordered_map<SlotKey, ContextSlot, SlotKeyHash>;
+
+        std::array<Entry, kInlineSlots> inline_{};
+        std::size_t size_ = 0;
+        bool spilled_ = false;
+        std::unique_ptr<SpillTable> spill_{};
+    };
+
     struct InjectContext
     {
         // Parent for nested @inject calls.
         InjectContext* parent = nullptr;
 
         // Resolved dependency cache for current scope only.
-        std::unordered_map<SlotKey, ContextSlot, SlotKeyHash> slots{};
+        ContextSlotMap slots{};
     };
 
     // One injectable call-chain state.
@@ -90,7 +216,7 @@ namespace cpp::blackmagic::depends
     inline void ResetInjectContextState(InjectContextState& state)
     {
         state.root.parent = nullptr;
-        state.root.slots.clear();
+        state.root.slots.Clear();
         state.context_stack.clear();
         state.context_stack.push_back(&state.root);
         state.explicit_overrides.clear();
@@ -534,22 +660,25 @@ namespace cpp::blackmagic::depends
         }
     }
 
-    [[nodiscard]] inline ContextSlot* FindSlotInChain(std::type_index key, const void* factory = nullptr)
+    [[nodiscard]] inline ContextSlot* FindSlotInChain(TypeKey key, const void* factory = nullptr)
     {
+        // Hash once, probe every level with it.
+        const SlotKey slot_key{ key, factory };
+        const std::size_t hash = SlotKeyHash{}(slot_key);
         for (InjectContext* ctx = CurrentContext(); ctx != nullptr; ctx = ctx->parent)
         {
-            const auto it = ctx->slots.find(SlotKey{ key, factory });
-            if (it != ctx->slots.end())
+            if (auto* slot = ctx->slots.Find(slot_key, hash))
             {
-                return &it->second;
+                return slot;
             }
         }
         return nullptr;
     }
 
-    inline ContextSlot& UpsertLocalSlot(std::type_index key, const void* factory, ContextSlot slot)
+    inline ContextSlot& UpsertLocalSlot(TypeKey key, const void* factory, ContextSlot slot)
     {
-        auto& out = CurrentContext()->slots[SlotKey{ key, factory }];
+        const SlotKey slot_key{ key, factory };
+        auto& out = CurrentContext()->slots.Upsert(slot_key, SlotKeyHash{}(slot_key));
         out = std::move(slot);
         return out;
     }
@@ -557,7 +686,7 @@ namespace cpp::blackmagic::depends
     template <typename T>
     void CacheRawSlot(T* ptr, std::shared_ptr<void> holder, const void* factory = nullptr)
     {
-        UpsertLocalSlot(typeid(T), factory, ContextSlot{
+        UpsertLocalSlot(TypeKeyOf<T>(), factory, ContextSlot{
             const_cast<void*>(static_cast<const void*>(ptr)),
             std::move(holder) });
     }
@@ -611,7 +740,7 @@ namespace cpp::blackmagic::depends
     inline const std::any* FindExplicitOverrideAny(
         const void* target,
         const void* factory,
-        std::type_index type)
+        TypeKey type)
     {
         auto& table = GetActiveState().explicit_overrides;
         const auto lookup_exact = [&](const void* in_target, const void* in_factory) -> const std::any* {
@@ -640,7 +769,7 @@ namespace cpp::blackmagic::depends
     inline const std::any* FindExplicitOverrideAnyExact(
         const void* target,
         const void* factory,
-        std::type_index type)
+        TypeKey type)
     {
         auto& table = GetActiveState().explicit_overrides;
         auto it = table.find(ExplicitValueKey{ target, factory, type });
@@ -655,7 +784,7 @@ namespace cpp::blackmagic::depends
     bool RegisterExplicitOverride(const void* target, const void* factory, U&& value)
     {
         auto& table = GetActiveState().explicit_overrides;
-        table[ExplicitValueKey{ target, factory, typeid(std::remove_cvref_t<U>) }] =
+        table[ExplicitValueKey{ target, factory, TypeKeyOf<U>() }] =
             std::any(std::forward<U>(value));
         return true;
     }
@@ -687,7 +816,7 @@ namespace cpp::blackmagic::depends
         return removed;
     }
 
-    inline bool RemoveExplicitOverride(const void* target, const void* factory, std::type_index type)
+    inline bool RemoveExplicitOverride(const void* target, const void* factory, TypeKey type)
     {
         auto& table = GetActiveState().explicit_overrides;
         return table.erase(ExplicitValueKey{ target, factory, type }) > 0;
@@ -696,7 +825,7 @@ namespace cpp::blackmagic::depends
     template <typename U>
     std::optional<U> FindExplicitOverrideExactTyped(const void* target, const void* factory)
     {
-        if (const auto* value = FindExplicitOverrideAnyExact(target, factory, typeid(U)); value != nullptr)
+        if (const auto* value = FindExplicitOverrideAnyExact(target, factory, TypeKeyOf<U>()); value != nullptr)
         {
             return AnyTo<U>(*value);
         }
@@ -706,13 +835,13 @@ namespace cpp::blackmagic::depends
     template <typename U>
     bool RemoveExplicitOverrideTyped(const void* target, const void* factory)
     {
-        return RemoveExplicitOverride(target, factory, typeid(U));
+        return RemoveExplicitOverride(target, factory, TypeKeyOf<U>());
     }
 
     template <typename U>
     [[nodiscard]] std::optional<U> TryResolveExplicitOverride(const void* target, const void* factory = nullptr)
     {
-        if (const auto* value = FindExplicitOverrideAny(target, factory, typeid(U)); value != nullptr)
+        if (const auto* value = FindExplicitOverrideAny(target, factory, TypeKeyOf<U>()); value != nullptr)
         {
             return AnyTo<U>(*value);
         }
@@ -52,8 +52,24 @@ namespace cpp::blackmagic::depends
             const void* target = TargetKeyOf<Target>();
 
             // Placeholder argument: resolve from default-arg metadata for this target/index.
+            // Compiled plans never await (task-like factories are left to the
+            // registry path), so they run inline here.
             const void* resolved_factory = nullptr;
-            if (co_await TryResolveDefaultArgForParamAsync<Declared>(target, Index, arg, &resolved_factory))
+            bool planned = false;
+            bool resolved = false;
+            if constexpr (std::is_pointer_v<Declared> || std::is_reference_v<Declared>)
+            {
+                if (const auto* plan = FindInjectArgPlan<Target, Index, Declared>())
+                {
+                    planned = true;
+                    resolved = TryResolveDefaultArgFromPlan<Declared>(*plan, target, arg, &resolved_factory);
+                }
+            }
+            if (!planned)
+            {
+                resolved = co_await TryResolveDefaultArgForParamAsync<Declared>(target, Index, arg, &resolved_factory);
+            }
+            if (resolved)
             {
                 if constexpr (std::is_reference_v<Declared>)
                 {
@@ -21,11 +21,27 @@ namespace cpp::blackmagic::depends
     template <auto Target, typename... Args>
     struct InjectCallResolverSync
     {
+        // Resolve one placeholder argument at parameter Index: through the plan
+        // compiled at Bind when there is one, else through registry metadata.
+        template <std::size_t Index, typename A>
+        static bool TryResolvePlaceholder(const void* target, A& arg, const void** out_factory)
+        {
+            using Declared = std::tuple_element_t<Index, std::tuple<Args...>>;
+            if constexpr (std::is_pointer_v<Declared> || std::is_reference_v<Declared>)
+            {
+                if (const auto* plan = FindInjectArgPlan<Target, Index, Declared>())
+                {
+                    return TryResolveDefaultArgFromPlan<Declared>(*plan, target, arg, out_factory);
+                }
+            }
+            return TryResolveDefaultArgForParam<Declared>(target, Index, arg, out_factory);
+        }
+
         // Resolve one argument at parameter Index.
         //
         // Contract:
         // - if arg is not placeholder: return arg as-is
-        // - if arg is placeholder: resolve via TryResolveDefaultArgForParam
+        // - if arg is placeholder: resolve via TryResolvePlaceholder
         // - on failure:
         //   - pointer/reference params -> MissingDependency
         //   - value params             -> InvalidPlaceholder
@@ -43,7 +59,7 @@ namespace cpp::blackmagic::depends
 
             // Placeholder argument: resolve from default-arg metadata for this target/index.
             const void* resolved_factory = nullptr;
-            if (TryResolveDefaultArgForParam<Declared>(target, Index, arg, &resolved_factory))
+            if (TryResolvePlaceholder<Index>(target, arg, &resolved_factory))
             {
                 if constexpr (std::is_reference_v<Declared>)
                 {
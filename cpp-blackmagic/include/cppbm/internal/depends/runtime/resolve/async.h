@@ -48,73 +48,7 @@ namespace cpp::blackmagic::depends
                 {
                     auto ptr_meta = co_await std::move(*ptr_meta_task);
                     set_factory(ptr_meta.factory);
-
-                    const bool is_plain_depends_placeholder =
-                        ptr_meta.factory == nullptr
-                        && IsDependsPlaceholder<Raw*>(ptr_meta.ptr);
-
-                    // Highest priority: context override table for exact key.
-                    if (TryPopulateRawSlotFromOverride<Raw>(target, ptr_meta.factory))
-                    {
-                        if constexpr (WriteOut)
-                        {
-                            if (auto* resolved = TryResolveRawPtr<Raw>(target, ptr_meta.factory, ptr_meta.cached))
-                            {
-                                out = static_cast<Param>(resolved);
-                                co_return true;
-                            }
-                        }
-                        else
-                        {
-                            co_return true;
-                        }
-                    }
-
-                    // Depends() placeholder metadata:
-                    // resolve from existing/explicit/default slot flow (factory == nullptr).
-                    if (is_plain_depends_placeholder)
-                    {
-                        auto* slot = EnsureRawSlot<Raw>(target, true, nullptr, ptr_meta.cached);
-                        if (slot == nullptr || slot->obj == nullptr)
-                        {
-                            co_return false;
-                        }
-                        if constexpr (WriteOut)
-                        {
-                            out = static_cast<Param>(slot->obj);
-                        }
-                        co_return true;
-                    }
-
-                    // Metadata already produced concrete pointer.
-                    // Cache it into current context with owned/borrowed policy.
-                    if (ptr_meta.ptr != nullptr)
-                    {
-                        if constexpr (WriteOut)
-                        {
-                            out = static_cast<Param>(ptr_meta.ptr);
-                        }
-
-                        auto* existing = FindSlotInChain(typeid(Raw), ptr_meta.factory);
-                        const bool same_cached_ptr =
-                            (existing != nullptr) && (existing->obj == ptr_meta.ptr);
-                        // Avoid replacing owned slot by borrowed slot for same pointer value.
-                        if (same_cached_ptr && !ptr_meta.owned)
-                        {
-                            co_return true;
-                        }
-
-                        if (ptr_meta.owned)
-                        {
-                            CacheOwnedRaw<Raw>(ptr_meta.ptr, ptr_meta.factory);
-                        }
-                        else
-                        {
-                            CacheBorrowedRaw<Raw>(ptr_meta.ptr, ptr_meta.factory);
-                        }
-                        co_return true;
-                    }
-                    co_return false;
+                    co_return ApplyDependsPtrMeta<Raw, WriteOut>(target, ptr_meta, out);
                 }
                 co_return false;
             };
@@ -11,6 +11,7 @@
 
 #include "../placeholder.h"
 #include "../context.h"
+#include "../../compile/plan.h"
 
 namespace cpp::blackmagic::depends
 {
@@ -33,7 +34,7 @@ namespace cpp::blackmagic::depends
         // 3) optional default construction (if allowed)
         if (cached)
         {
-            if (auto* slot = FindSlotInChain(typeid(T), factory); slot && slot->obj != nullptr)
+            if (auto* slot = FindSlotInChain(TypeKeyOf<T>(), factory); slot && slot->obj != nullptr)
             {
                 return slot;
             }
@@ -41,7 +42,7 @@ namespace cpp::blackmagic::depends
 
         if (TryPopulateRawSlotFromOverride<T>(target, factory))
         {
-            auto* slot = FindSlotInChain(typeid(T), factory);
+            auto* slot = FindSlotInChain(TypeKeyOf<T>(), factory);
             if (slot && slot->obj != nullptr)
             {
                 return slot;
@@ -56,7 +57,7 @@ namespace cpp::blackmagic::depends
         if constexpr (std::is_default_constructible_v<T>)
         {
             CacheOwnedDefault<T>(factory);
-            return FindSlotInChain(typeid(T), factory);
+            return FindSlotInChain(TypeKeyOf<T>(), factory);
         }
 
         return nullptr;
@@ -195,6 +196,122 @@ namespace cpp::blackmagic::depends
         }
     }
 
+    // Apply one pointer-metadata entry (DependsPtrValue<Raw>) for parameter A.
+    // Shared by registry metadata and compiled plans (plan.h):
+    // - reference params (WriteOut=false): slot preparation only
+    // - pointer params   (WriteOut=true): also writes out pointer argument
+    template <typename Raw, bool WriteOut, typename A>
+    bool ApplyDependsPtrMeta(
+        const void* target,
+        const DependsPtrValue<Raw>& ptr_meta,
+        A& out)
+    {
+        using Param = std::remove_cv_t<std::remove_reference_t<A>>;
+
+        const bool is_plain_depends_placeholder =
+            ptr_meta.factory == nullptr
+            && IsDependsPlaceholder<Raw*>(ptr_meta.ptr);
+
+        // Highest priority: context override table for exact key.
+        if (TryPopulateRawSlotFromOverride<Raw>(target, ptr_meta.factory))
+        {
+            if constexpr (WriteOut)
+            {
+                if (auto* resolved = TryResolveRawPtr<Raw>(target, ptr_meta.factory, ptr_meta.cached))
+                {
+                    out = static_cast<Param>(resolved);
+                    return true;
+                }
+            }
+            else
+            {
+                return true;
+            }
+        }
+
+        // Depends() placeholder metadata:
+        // resolve from existing/explicit/default slot flow (factory == nullptr).
+        if (is_plain_depends_placeholder)
+        {
+            auto* slot = EnsureRawSlot<Raw>(target, true, nullptr, ptr_meta.cached);
+            if (slot == nullptr || slot->obj == nullptr)
+            {
+                return false;
+            }
+            if constexpr (WriteOut)
+            {
+                out = static_cast<Param>(slot->obj);
+            }
+            return true;
+        }
+
+        // Metadata already produced concrete pointer.
+        // Cache it into current context with owned/borrowed policy.
+        if (ptr_meta.ptr != nullptr)
+        {
+            if constexpr (WriteOut)
+            {
+                out = static_cast<Param>(ptr_meta.ptr);
+            }
+
+            auto* existing = FindSlotInChain(TypeKeyOf<Raw>(), ptr_meta.factory);
+            const bool same_cached_ptr =
+                (existing != nullptr) && (existing->obj == ptr_meta.ptr);
+
+            // Keep existing ownership state when metadata pointer is exactly the same.
+            // Avoid replacing owned slot by borrowed slot for same pointer value.
+            if (same_cached_ptr && !ptr_meta.owned)
+            {
+                return true;
+            }
+
+            if (ptr_meta.owned)
+            {
+                CacheOwnedRaw<Raw>(ptr_meta.ptr, ptr_meta.factory);
+            }
+            else
+            {
+                CacheBorrowedRaw<Raw>(ptr_meta.ptr, ptr_meta.factory);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Resolve one Depends placeholder through a plan compiled at Bind.
+    // Same semantics as the pointer-metadata path of
+    // TryResolveDefaultArgForParam, with metadata rebuilt from the plan
+    // instead of the registry: no lookup, no std::function, no std::any.
+    template <typename A>
+    bool TryResolveDefaultArgFromPlan(
+        const InjectArgPlanEntry<DependsRawFromParamT<A>>& plan,
+        const void* target,
+        A& out,
+        const void** out_factory = nullptr)
+    {
+        using Raw = DependsRawFromParamT<A>;
+
+        DependsPtrValue<Raw> ptr_meta{};
+        ptr_meta.cached = plan.cached;
+        if (plan.strategy == InjectArgStrategy::Factory)
+        {
+            ptr_meta.ptr = plan.produce(plan.state);
+            ptr_meta.owned = plan.owned;
+            ptr_meta.factory = plan.factory;
+        }
+        else
+        {
+            ptr_meta.ptr = DependsPointerMarker<Raw*>();
+        }
+
+        const bool resolved = ApplyDependsPtrMeta<Raw, !std::is_reference_v<A>>(target, ptr_meta, out);
+        if (out_factory != nullptr)
+        {
+            *out_factory = resolved ? ptr_meta.factory : nullptr;
+        }
+        return resolved;
+    }
+
     // Resolve one default-argument metadata entry for parameter A.
     //
     // Expected usage:
@@ -222,7 +339,7 @@ namespace cpp::blackmagic::depends
                 }
             };
 
-        // Shared pointer-metadata resolver for both:
+        // Pointer-metadata path for both:
         // - reference params (WriteOut=false): slot preparation only
         // - pointer params   (WriteOut=true): also writes out pointer argument
         auto resolve_ptr_meta = [&]<typename Raw, bool WriteOut>() -> bool
@@ -230,75 +347,7 @@ namespace cpp::blackmagic::depends
                 if (auto ptr_meta = InjectRegistry::Resolve<DependsPtrValue<Raw>>(target, index))
                 {
                     set_factory(ptr_meta->factory);
-
-                    const bool is_plain_depends_placeholder =
-                        ptr_meta->factory == nullptr
-                        && IsDependsPlaceholder<Raw*>(ptr_meta->ptr);
-
-                    // Highest priority: context override table for exact key.
-                    if (TryPopulateRawSlotFromOverride<Raw>(target, ptr_meta->factory))
-                    {
-                        if constexpr (WriteOut)
-                        {
-                            if (auto* resolved = TryResolveRawPtr<Raw>(target, ptr_meta->factory, ptr_meta->cached))
-                            {
-                                out = static_cast<Param>(resolved);
-                                return true;
-                            }
-                        }
-                        else
-                        {
-                            return true;
-                        }
-                    }
-
-                    // Depends() placeholder metadata:
-                    // resolve from existing/explicit/default slot flow (factory == nullptr).
-                    if (is_plain_depends_placeholder)
-                    {
-                        auto* slot = EnsureRawSlot<Raw>(target, true, nullptr, ptr_meta->cached);
-                        if (slot == nullptr || slot->obj == nullptr)
-                        {
-                            return false;
-                        }
-                        if constexpr (WriteOut)
-                        {
-                            out = static_cast<Param>(slot->obj);
-                        }
-                        return true;
-                    }
-
-                    // Metadata already produced concrete pointer.
-                    // Cache it into current context with owned/borrowed policy.
-                    if (ptr_meta->ptr != nullptr)
-                    {
-                        if constexpr (WriteOut)
-                        {
-                            out = static_cast<Param>(ptr_meta->ptr);
-                        }
-
-                        auto* existing = FindSlotInChain(typeid(Raw), ptr_meta->factory);
-                        const bool same_cached_ptr =
-                            (existing != nullptr) && (existing->obj == ptr_meta->ptr);
-
-                        // Keep existing ownership state when metadata pointer is exactly the same.
-                        // Avoid replacing owned slot by borrowed slot for same pointer value.
-                        if (same_cached_ptr && !ptr_meta->owned)
-                        {
-                            return true;
-                        }
-
-                        if (ptr_meta->owned)
-                        {
-                            CacheOwnedRaw<Raw>(ptr_meta->ptr, ptr_meta->factory);
-                        }
-                        else
-                        {
-                            CacheBorrowedRaw<Raw>(ptr_meta->ptr, ptr_meta->factory);
-                        }
-                        return true;
-                    }
-                    return false;
+                    return ApplyDependsPtrMeta<Raw, WriteOut>(target, *ptr_meta, out);
                 }
                 return false;
             };
@@ -0,0 +1,153 @@
+// File role:
+// Per-thread bump allocator for decorator CallContext arenas that are too
+// large for the stack.
+//
+// HookPipeline::Dispatch keeps small arenas on the stack (alloca). Above
+// CPPBM_HOOK_STACK_ARENA_LIMIT bytes it spills here instead, so deep
+// recursion through hooked functions with large contexts does not exhaust
+// the thread stack.
+//
+// Allocation discipline:
+// - dispatch frames nest strictly (LIFO), so release is just "rewind to the
+//   mark taken at acquire time"
+// - blocks are kept after rewind and reused; steady-state spills do not touch
+//   the heap
+
+#ifndef __CPPBM_HOOK_ARENA_H__
+#define __CPPBM_HOOK_ARENA_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "../utils/noncopyable.h"
+
+// Largest per-dispatch context arena placed on the stack; bigger arenas spill
+// to the per-thread ContextArena. Override at compile time if needed.
+#ifndef CPPBM_HOOK_STACK_ARENA_LIMIT
+#define CPPBM_HOOK_STACK_ARENA_LIMIT 4096
+#endif
+
+namespace cpp::blackmagic::hook
+{
+    // Align a pointer up to a power-of-two boundary.
+    inline unsigned char* AlignPointer(void* ptr, std::size_t align)
+    {
+        const auto raw = reinterpret_cast<std::uintptr_t>(ptr);
+        const auto aligned = (raw + (align - 1)) & ~static_cast<std::uintptr_t>(align - 1);
+        return reinterpret_cast<unsigned char*>(aligned);
+    }
+
+    class ContextArena : private utils::NonCopyable
+    {
+    public:
+        struct Mark
+        {
+            std::size_t block = 0;
+            std::size_t used = 0;
+        };
+
+        // RAII frame used by Dispatch: takes a mark on first Allocate and
+        // rewinds to it on scope exit (including exception unwinding).
+        class Scope : private utils::NonCopyable
+        {
+        public:
+            Scope() = default;
+
+            ~Scope()
+            {
+                if (arena_ != nullptr)
+                {
+                    arena_->Rewind(mark_);
+                }
+            }
+
+            unsigned char* Allocate(std::size_t bytes, std::size_t align)
+            {
+                if (arena_ == nullptr)
+                {
+                    arena_ = &Local();
+                    mark_ = arena_->Position();
+                }
+                return arena_->Allocate(bytes, align);
+            }
+
+        private:
+            ContextArena* arena_ = nullptr;
+            Mark mark_{};
+        };
+
+        static ContextArena& Local()
+        {
+            static thread_local ContextArena arena{};
+            return arena;
+        }
+
+        [[nodiscard]] Mark Position() const
+        {
+            return Mark{ current_, blocks_.empty() ? 0 : blocks_[current_].used };
+        }
+
+        unsigned char* Allocate(std::size_t bytes, std::size_t align)
+        {
+            // Try current block, then any retained block after it, else grow.
+            for (; current_ < blocks_.size(); ++current_)
+            {
+                Block& block = blocks_[current_];
+                unsigned char* base = block.memory.get();
+                unsigned char* out = AlignPointer(base + block.used, align);
+                const auto end = static_cast<std::size_t>(out - base) + bytes;
+                if (end <= block.size)
+                {
+                    block.used = end;
+                    return out;
+                }
+                if (current_ + 1 < blocks_.size())
+                {
+                    blocks_[current_ + 1].used = 0;
+                }
+            }
+
+            const std::size_t size = std::max(kBlockBytes, bytes + align);
+            Block block{};
+            block.memory.reset(new unsigned char[size]);
+            block.size = size;
+            blocks_.push_back(std::move(block));
+            current_ = blocks_.size() - 1;
+
+            Block& fresh = blocks_.back();
+            unsigned char* out = AlignPointer(fresh.memory.get(), align);
+            fresh.used = static_cast<std::size_t>(out - fresh.memory.get()) + bytes;
+            return out;
+        }
+
+        void Rewind(const Mark& mark)
+        {
+            current_ = mark.block;
+            if (current_ < blocks_.size())
+            {
+                blocks_[current_].used = mark.used;
+            }
+        }
+
+    private:
+        static constexpr std::size_t kBlockBytes = 64 * 1024;
+
+        struct Block
+        {
+            std::unique_ptr<unsigned char[]> memory{};
+            std::size_t size = 0;
+            std::size_t used = 0;
+        };
+
+        ContextArena() = default;
+
+        std::vector<Block> blocks_{};
+        std::size_t current_ = 0;
+    };
+}
+
+#endif // __CPPBM_HOOK_ARENA_H__
@@ -13,6 +13,16 @@ namespace cpp::blackmagic::hook
         std::add_pointer_t<std::remove_reference_t<Arg>>,
         std::remove_cv_t<Arg>>;
 
+    // Per-call view over the dispatch parameters.
+    // By-value parameters of Dispatch are already private copies, so slots
+    // alias them directly (no second copy); reference parameters keep one
+    // rebindable pointer cell.
+    template <typename Arg>
+    using ArgViewT = std::conditional_t<
+        std::is_reference_v<Arg>,
+        ArgStorageT<Arg>,
+        ArgStorageT<Arg>&>;
+
     template <typename Arg>
     class ArgSlot
     {
@@ -100,7 +110,7 @@ namespace cpp::blackmagic::hook
     };
 
     template <typename Arg>
-    ArgStorageT<Arg> InitArgStorage(Arg& arg)
+    ArgViewT<Arg> InitArgView(Arg& arg)
     {
         if constexpr (std::is_reference_v<Arg>)
         {
@@ -125,7 +135,8 @@ namespace cpp::blackmagic::hook
         }
         else
         {
-            return storage;
+            // Last use of the per-call value: hand it to the original by move.
+            return std::move(storage);
         }
     }
 }
@@ -0,0 +1,77 @@
+// File role:
+// Transactional batch of hook installs (src/internal/hook/batch.cpp).
+//
+// While a batch is open, HookState::InstallAt still creates each hook (so its
+// trampoline is known) but only queues the enable with the backend. Commit
+// applies every queued patch in one backend pass (Hooker::ApplyQueued), which
+// groups the code writes by page instead of flipping page protection once per
+// target. If that pass fails, every hook queued in the batch is removed again
+// and reported as EnableHookFailed: either all targets of a batch go live or
+// none do.
+//
+// Batches nest; only the outermost Commit applies the queue.
+
+#ifndef __CPPBM_HOOK_BATCH_H__
+#define __CPPBM_HOOK_BATCH_H__
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "../utils/noncopyable.h"
+
+namespace cpp::blackmagic::hook
+{
+    class HookState;
+
+    class HookBatch : private utils::NonCopyable
+    {
+    public:
+        static HookBatch& GetInstance();
+
+        void Begin();
+
+        // Close one nesting level; the outermost level applies the queue.
+        // Returns false when the backend could not apply it (see HookError).
+        bool Commit();
+
+        // Close every open level and apply the queue.
+        bool CommitAll();
+
+        [[nodiscard]] bool IsOpen() const;
+
+        // Queue the backend enable of `target` for `state` if a batch is open.
+        // Returns false (nothing queued) when the caller must enable now.
+        bool Defer(HookState* state, void* target);
+
+    private:
+        HookBatch();
+
+        bool ApplyLocked(std::unique_lock<std::mutex>& lock);
+
+        mutable std::mutex mtx_{};
+        std::size_t depth_ = 0;
+        std::vector<HookState*> pending_{};
+    };
+
+    // Open a batch: decorators registered until the matching CommitHookBatch()
+    // are installed together.
+    inline void BeginHookBatch()
+    {
+        HookBatch::GetInstance().Begin();
+    }
+
+    inline bool CommitHookBatch()
+    {
+        return HookBatch::GetInstance().Commit();
+    }
+
+    // Apply everything queued so far and close all open batches, including the
+    // startup batch opened by CPPBM_HOOK_BATCH_STARTUP.
+    inline bool InstallAll()
+    {
+        return HookBatch::GetInstance().CommitAll();
+    }
+}
+
+#endif // __CPPBM_HOOK_BATCH_H__
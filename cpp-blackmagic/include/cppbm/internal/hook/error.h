@@ -13,6 +13,8 @@ namespace cpp::blackmagic::hook
         InvalidInstallArgument,
         CreateHookFailed,
         EnableHookFailed,
+        DisableHookFailed,
+        DetourPoolExhausted,
     };
 
     struct HookError
@@ -0,0 +1,54 @@
+// File role:
+// Hookless decorators through source expansion (decorator.py --expand).
+//
+// Preprocess renames a decorated definition `R foo(params)` to a
+// translation-unit-local `__cppbm_orig_foo` and defines a forwarding wrapper
+// under the original name:
+//
+//   static R __cppbm_orig_foo(params) { ...original body... }
+//   R foo(params) { return Expanded<&foo, &__cppbm_orig_foo>::Call(args...); }
+//
+// plus, ahead of the decorator bindings of the file,
+//
+//   static const bool __cppbm_expand_foo = Expanded<&foo, &__cppbm_orig_foo>::Bind();
+//
+// Every call of foo then enters the pipeline from ordinary C++ code: no hook
+// backend, no patched prologue, and the original is a compile-time callee
+// the compiler may inline into the wrapper (as it may inline statically
+// chained decorators, see static_chain.h). Bind() publishes
+// __cppbm_orig_foo as the pipeline original, so CallOriginal() and bypass
+// keep working and the target reports Installed.
+
+#ifndef __CPPBM_HOOK_EXPAND_H__
+#define __CPPBM_HOOK_EXPAND_H__
+
+#include "hook.h"
+
+namespace cpp::blackmagic::hook
+{
+    template <auto Target, auto Original, typename Fn = decltype(Target)>
+    struct Expanded;
+
+    template <auto Target, auto Original, typename R, typename... Args>
+    struct Expanded<Target, Original, R(*)(Args...)>
+    {
+        static_assert(std::is_same_v<decltype(Original), R(*)(Args...)>,
+            "Expanded: the renamed original must keep the target's signature.");
+
+        using Base = FreeHookBase<Target, R, Args...>;
+
+        // Wrapper body. Arguments arrive as the wrapper's own parameters,
+        // forwarded (by-value ones moved), exactly as Detour would pass them.
+        static R Call(Args&&... args)
+        {
+            return Base::GetPipeline().template DispatchTo<Original>(std::forward<Args>(args)...);
+        }
+
+        static bool Bind()
+        {
+            return Base::GetPipeline().BindLinked(reinterpret_cast<void*>(Original));
+        }
+    };
+}
+
+#endif // __CPPBM_HOOK_EXPAND_H__
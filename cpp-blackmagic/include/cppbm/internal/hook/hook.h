@@ -7,6 +7,7 @@
 
 #include "pipeline.h"
 #include "registry.h"
+#include "vtable.h"
 #include "../utils/noncopyable.h"
 
 #ifdef _WIN32
@@ -57,6 +58,9 @@ namespace cpp::blackmagic::hook
         }
     };
 
+    template <auto Target, typename Fn>
+    struct LinkWrap;
+
     // Free-function bridge:
     // - exposes GetPipeline
     // - routes detour to pipeline dispatch
@@ -78,20 +82,29 @@ namespace cpp::blackmagic::hook
     public:
         static Pipeline& GetPipeline()
         {
-            return GetOrCreateHookPipeline<Pipeline>(
+            // Resolved once per Target; later calls (including every Detour)
+            // only pay the initialized-static check, never the registry lock.
+            static Pipeline& pipeline = GetOrCreateHookPipeline<Pipeline>(
                 reinterpret_cast<void*>(Target),
                 reinterpret_cast<void*>(Target),
                 reinterpret_cast<void*>(&Detour));
+            return pipeline;
         }
 
     private:
+        // Link-time glue (link_wrap.h) jumps straight here.
+        template <auto, typename>
+        friend struct LinkWrap;
+
         static R Detour(Args... args)
         {
-            return GetPipeline().Dispatch(args...);
+            return GetPipeline().Dispatch(std::forward<Args>(args)...);
         }
     };
 
     // Member-function bridge for mutable/const member functions.
+    // Virtual targets hook the vtable slot of the member pointer's class
+    // (see vtable.h); others are inline-patched by the process-wide backend.
     template <auto Target, typename MemberFn, typename ThisPtr, typename R, typename... Args>
     class MemberHookBase
         : public HookPipelineNodeBase<
@@ -113,22 +126,41 @@ namespace cpp::blackmagic::hook
     public:
         static Pipeline& GetPipeline()
         {
+            static Pipeline& pipeline = CreatePipeline();
+            return pipeline;
+        }
+
+    private:
+        static Pipeline& CreatePipeline()
+        {
+            using Class = std::remove_cv_t<std::remove_pointer_t<ThisPtr>>;
+            const VirtualTarget virtual_target = ResolveVirtualTarget<Class>(Target);
+            if (virtual_target.is_virtual)
+            {
+                // One pipeline per (class, slot). An unresolved slot keeps a
+                // null target, so install reports InvalidInstallArgument.
+                void* slot = static_cast<void*>(virtual_target.slot);
+                return GetOrCreateHookPipeline<Pipeline>(
+                    slot != nullptr ? slot : reinterpret_cast<void*>(&Detour),
+                    slot,
+                    reinterpret_cast<void*>(&Detour),
+                    &GetVtableHooker());
+            }
             return GetOrCreateHookPipeline<Pipeline>(
                 MemberPointerToAddress(Target),
                 MemberPointerToAddress(Target),
                 reinterpret_cast<void*>(&Detour));
         }
 
-    private:
 #ifdef _CPPBM_HOOK_WIN32
         static R __fastcall Detour(ThisPtr thiz, void* /*edx*/, Args... args)
         {
-            return GetPipeline().Dispatch(thiz, args...);
+            return GetPipeline().Dispatch(std::forward<ThisPtr>(thiz), std::forward<Args>(args)...);
         }
 #else
         static R Detour(ThisPtr thiz, Args... args)
         {
-            return GetPipeline().Dispatch(thiz, args...);
+            return GetPipeline().Dispatch(std::forward<ThisPtr>(thiz), std::forward<Args>(args)...);
         }
 #endif
     };
@@ -151,16 +183,19 @@ namespace cpp::blackmagic::hook
     public:
         static Pipeline& GetPipeline()
         {
-            return GetOrCreateHookPipeline<Pipeline>(
+            // Resolved once per Target; later calls (including every Detour)
+            // only pay the initialized-static check, never the registry lock.
+            static Pipeline& pipeline = GetOrCreateHookPipeline<Pipeline>(
                 reinterpret_cast<void*>(Target),
                 reinterpret_cast<void*>(Target),
                 reinterpret_cast<void*>(&Detour));
+            return pipeline;
         }
 
     private:
         static R __stdcall Detour(Args... args)
         {
-            return GetPipeline().Dispatch(args...);
+            return GetPipeline().Dispatch(std::forward<Args>(args)...);
         }
     };
 
@@ -181,16 +216,19 @@ namespace cpp::blackmagic::hook
     public:
         static Pipeline& GetPipeline()
         {
-            return GetOrCreateHookPipeline<Pipeline>(
+            // Resolved once per Target; later calls (including every Detour)
+            // only pay the initialized-static check, never the registry lock.
+            static Pipeline& pipeline = GetOrCreateHookPipeline<Pipeline>(
                 reinterpret_cast<void*>(Target),
                 reinterpret_cast<void*>(Target),
                 reinterpret_cast<void*>(&Detour));
+            return pipeline;
         }
 
     private:
         static R __fastcall Detour(Args... args)
         {
-            return GetPipeline().Dispatch(args...);
+            return GetPipeline().Dispatch(std::forward<Args>(args)...);
         }
     };
 #endif // _CPPBM_HOOK_WIN32
@@ -13,6 +13,13 @@ namespace cpp::blackmagic::hook
 		virtual bool DisableHook(void* target) = 0;
 		virtual bool RemoveHook(void* target) = 0;
 
+		// Batched enable (see batch.h): queue created hooks, then patch every
+		// queued target in one pass. A failed ApplyQueued() leaves none of the
+		// queued targets enabled and drops the queue.
+		// Backends without a queue enable immediately.
+		virtual bool QueueEnableHook(void* target) { return EnableHook(target); }
+		virtual bool ApplyQueued() { return true; }
+
 	public:
 		static Hooker& GetInstance();
 	};
@@ -0,0 +1,76 @@
+// File role:
+// Zero-patch hooking through the GNU linker's --wrap option.
+//
+// `-Wl,--wrap=<sym>` resolves undefined references to <sym> to __wrap_<sym>,
+// and __real_<sym> back to <sym>. CPPBM_LINK_WRAP(name, (&Target)), placed in
+// the translation unit that defines Target (decorator.py --link-wrap emits it),
+// provides the __wrap_ side:
+// - __wrap_<mangled>: one direct jump into the pipeline detour, so the
+//   decorated call path has no patched prologue and no trampoline;
+// - <mangled> recorded in section .cppbm_wrap (SHF_EXCLUDE: dropped from the
+//   linked image), from which scripts/link_wrap.py writes the --wrap options
+//   at PRE_LINK time;
+// - a priority-101 constructor that hands the pipeline the real definition
+//   (what __real_<mangled> resolves to) as its original before any decorator
+//   registers, so the hook backend is never called for Target.
+//
+// The mangled name is never spelled in source: the "%c" asm operand modifier
+// prints the symbol of the constant address operand.
+//
+// Scope: ELF, GCC/Clang, x86-64 and AArch64, non-PIC objects (executables,
+// PIE included) and free functions. --wrap only rewrites references between
+// objects, so calls made from inside the defining translation unit reach
+// the undecorated definition.
+
+#ifndef __CPPBM_HOOK_LINK_WRAP_H__
+#define __CPPBM_HOOK_LINK_WRAP_H__
+
+#include "hook.h"
+
+#if defined(__x86_64__)
+#define CPPBM_LINK_WRAP_JUMP "jmp"
+#elif defined(__aarch64__)
+#define CPPBM_LINK_WRAP_JUMP "b"
+#endif
+
+namespace cpp::blackmagic::hook
+{
+    template <auto Target, typename R, typename... Args>
+    struct LinkWrap<Target, R(*)(Args...)>
+    {
+        using Base = FreeHookBase<Target, R, Args...>;
+
+        static constexpr R(*kDetour)(Args...) = &Base::Detour;
+
+        static bool Bind(void* real)
+        {
+            return Base::GetPipeline().BindLinked(real);
+        }
+    };
+}
+
+#ifdef CPPBM_LINK_WRAP_JUMP
+#define CPPBM_LINK_WRAP(NAME, TARGET)                                                       \
+    [[gnu::constructor(101), gnu::used, gnu::noinline, gnu::noclone]] static void NAME()   \
+    {                                                                                      \
+        using CppbmLinkWrap = ::cpp::blackmagic::hook::LinkWrap<TARGET, decltype(TARGET)>; \
+        __asm__ volatile(                                                                  \
+            ".pushsection .text.cppbm_wrap,\"ax\",@progbits\n"                             \
+            ".globl __wrap_%c0\n"                                                          \
+            ".type __wrap_%c0, @function\n"                                                \
+            "__wrap_%c0:\n\t"                                                              \
+            CPPBM_LINK_WRAP_JUMP " %c1\n"                                                  \
+            ".size __wrap_%c0, . - __wrap_%c0\n"                                           \
+            ".popsection\n"                                                                \
+            ".pushsection .cppbm_wrap,\"e\",@progbits\n"                                   \
+            ".asciz \"%c0\"\n"                                                             \
+            ".popsection\n"                                                                \
+            : : "i"(TARGET), "i"(CppbmLinkWrap::kDetour));                                 \
+        (void)CppbmLinkWrap::Bind(reinterpret_cast<void*>(TARGET));                        \
+    }
+#else
+#define CPPBM_LINK_WRAP(NAME, TARGET) \
+    static_assert(sizeof(decltype(TARGET)) == 0, "CPPBM_LINK_WRAP: unsupported architecture (x86-64/AArch64 only)");
+#endif
+
+#endif // __CPPBM_HOOK_LINK_WRAP_H__
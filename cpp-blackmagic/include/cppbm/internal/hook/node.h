@@ -8,6 +8,47 @@
 
 namespace cpp::blackmagic::hook
 {
+    // Natural alignment implied by a context size: the largest power of two
+    // dividing it, capped at alignof(std::max_align_t). Any T with
+    // sizeof(T) == bytes is aligned correctly by this.
+    inline constexpr std::size_t NaturalContextAlign(std::size_t bytes)
+    {
+        if (bytes == 0)
+        {
+            return 1;
+        }
+        const std::size_t low_bit = bytes & (~bytes + 1);
+        return low_bit < alignof(std::max_align_t) ? low_bit : alignof(std::max_align_t);
+    }
+
+    // Round a requested ContextAlign() up to a power of two (0 means 1).
+    inline constexpr std::size_t NormalizeContextAlign(std::size_t align)
+    {
+        std::size_t out = 1;
+        while (out < align)
+        {
+            out <<= 1;
+        }
+        return out;
+    }
+
+    // Signature-independent part of every decorator node.
+    // HookPipelineCore only ever sees this base: chain bookkeeping and arena
+    // layout never depend on (R, Args...).
+    class DecoratorNodeBase
+    {
+    public:
+        virtual ~DecoratorNodeBase() = default;
+
+        // Requested bytes for this decorator's per-call context slot.
+        // Return 0 when no context storage is needed.
+        virtual std::size_t ContextSize() const { return 0; }
+
+        // Required alignment of the context slot (power of two).
+        // Override for over-aligned frames (SIMD, cache-line).
+        virtual std::size_t ContextAlign() const { return NaturalContextAlign(ContextSize()); }
+    };
+
     // DecoratorNode defines extension points seen by HookPipeline.
     //
     // Two API layers:
@@ -17,15 +58,9 @@ namespace cpp::blackmagic::hook
     // Default implementation of slot-based callbacks forwards to simple callbacks.
     // This keeps user decorators concise while still allowing argument rebinding via ArgSlot.
     template <typename R, typename... Args>
-    class DecoratorNode
+    class DecoratorNode : public DecoratorNodeBase
     {
     public:
-        virtual ~DecoratorNode() = default;
-
-        // Requested bytes for this decorator's per-call context slot.
-        // Return 0 when no context storage is needed.
-        virtual std::size_t ContextSize() const { return 0; }
-
         virtual bool BeforeCall(Args&... /*args*/) { return true; }
 
         virtual bool BeforeCall(CallContext& ctx, Args&... args)
@@ -54,15 +89,9 @@ namespace cpp::blackmagic::hook
     };
 
     template <typename... Args>
-    class DecoratorNode<void, Args...>
+    class DecoratorNode<void, Args...> : public DecoratorNodeBase
     {
     public:
-        virtual ~DecoratorNode() = default;
-
-        // Requested bytes for this decorator's per-call context slot.
-        // Return 0 when no context storage is needed.
-        virtual std::size_t ContextSize() const { return 0; }
-
         virtual bool BeforeCall(Args&... /*args*/) { return true; }
 
         virtual bool BeforeCall(CallContext& ctx, Args&... args)
@@ -0,0 +1,51 @@
+// File role:
+// Profiler symbols for code the hook backends generate at runtime
+// (src/internal/hook/perf_map.cpp).
+//
+// Trampolines (relocated prologue + jump back) and relays live in anonymous
+// executable memory, so `perf` reports samples in them as [unknown]. Each
+// backend records every region it generates here, named after its target:
+//   cppbm::trampoline::Foo(int)      original prologue, reached by CallOriginal
+//   cppbm::relay::Foo(int)           absolute jump from the patch to the detour
+// Detours and the target itself are ordinary functions of their image and are
+// already symbolized by the profiler.
+//
+// Output (Linux/Android only; elsewhere regions are only recorded):
+// - Map:     lines "<start> <size> <name>" appended to /tmp/perf-<pid>.map,
+//            read by `perf report` directly
+// - JitDump: additionally $JITDUMP_DIR/jit-<pid>.dump (default /tmp) with a
+//            code-load record per region (bytes included), for
+//            `perf record -k mono` + `perf inject --jit`
+//
+// Off by default. Enabled from the environment at the first hook install
+// (CPPBM_PERF_MAP=1 or map, CPPBM_PERF_MAP=jitdump) or at any time with
+// SetPerfMapMode(); regions generated before that are written out then.
+
+#ifndef __CPPBM_HOOK_PERF_MAP_H__
+#define __CPPBM_HOOK_PERF_MAP_H__
+
+#include <cstddef>
+
+namespace cpp::blackmagic::hook
+{
+    enum class PerfMapMode
+    {
+        Off,
+        Map,
+        JitDump,
+    };
+
+    // Switching on writes every region recorded so far; switching off only
+    // stops further output (files already written are kept).
+    void SetPerfMapMode(PerfMapMode mode);
+    PerfMapMode GetPerfMapMode();
+
+    // Backend side: `size` bytes of generated code at `code`, of kind `role`
+    // ("trampoline", "relay", ...) for the hook on `target`. `code` must be
+    // readable and hold its final bytes (JitDump copies them). Only the
+    // pointers are kept; the name is built when the region is written, so
+    // `role` must have static storage duration.
+    void RegisterPerfRegion(const void* code, std::size_t size, const void* target, const char* role);
+}
+
+#endif // __CPPBM_HOOK_PERF_MAP_H__
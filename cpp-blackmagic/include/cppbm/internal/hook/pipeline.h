@@ -1,17 +1,14 @@
 #ifndef __CPPBM_HOOK_PIPELINE_H__
 #define __CPPBM_HOOK_PIPELINE_H__
 
-#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <exception>
 #include <functional>
-#include <list>
 #include <memory>
-#include <mutex>
 #include <tuple>
 #include <type_traits>
 #include <utility>
-#include <vector>
 
 #ifdef _MSC_VER
 #include <malloc.h>
@@ -21,8 +18,7 @@
 #define CPPBM_HOOK_ALLOCA alloca
 #endif
 
-#include "node.h"
-#include "state.h"
+#include "pipeline_core.h"
 
 namespace cpp::blackmagic::hook
 {
@@ -56,262 +52,226 @@ namespace cpp::blackmagic::hook
     // 2) If all returned true, invoke original once
     // 3) Walk invoked decorators in reverse order and call After...
     //
+    // Code layout:
+    // - everything that does not depend on (R, Args...) lives in the shared
+    //   HookPipelineCore (pipeline_core.h), compiled once into the library:
+    //   install state, chain registration, snapshots, arena layout and the
+    //   Before/After walks
+    // - this template only adds the typed trampolines: argument views/slots,
+    //   two node thunks and the call to the original
+    //
     // Context model:
-    // - each decorator can request ContextSize()
-    // - pipeline computes one per-node offset table
-    // - each Dispatch allocates one contiguous arena (alloca)
+    // - each decorator can request ContextSize() and ContextAlign()
+    // - the core packs slices tightly (each at its own alignment) into one
+    //   per-node offset table, stored next to the node pointers as parallel
+    //   contiguous arrays (nodes[i] <-> slices[i])
+    // - each Dispatch allocates one contiguous arena aligned to the largest
+    //   slice alignment: alloca up to CPPBM_HOOK_STACK_ARENA_LIMIT bytes,
+    //   otherwise the per-thread ContextArena (see arena.h)
     // - each invoked node receives a CallContext view for its slice
     //
+    // Concurrency model:
+    // - writers (Register/Unregister) edit the chain under a mutex and publish
+    //   an immutable snapshot with one atomic exchange
+    // - Dispatch never locks: it enters an epoch read section (per-thread
+    //   counter stripe) and loads the current snapshot; concurrent callers of
+    //   one target run in parallel
+    // - Register only publishes; the snapshot it replaced is parked, and freed
+    //   without waiting once no call is in flight
+    // - Unregister waits for a grace period, frees parked snapshots, and
+    //   returns only when no other thread can still be running the removed node
+    //
+    // Argument forwarding:
+    // - Detour owns the by-value parameters; Dispatch and CallOriginal take
+    //   them by reference (Args&&... collapses to T&& / T&), and the original
+    //   receives them by move: one move, zero copies per hooked call
+    //
     // Important behavior:
-    // - nested calls are safe because each Dispatch has independent stack arena
-    // - no heap allocation in context path
+    // - nested calls are safe because each Dispatch has independent arena
+    // - no heap allocation on the dispatch path (context or bookkeeping) once
+    //   the per-thread spill arena, if used at all, has grown to its peak
     template <typename OrigFn, typename R, typename... Args>
-    class HookPipeline : private HookState<OrigFn>
+    class HookPipeline : private HookPipelineCore
     {
     public:
-        using Core = HookState<OrigFn>;
+        using Core = HookPipelineCore;
         using Node = DecoratorNode<R, Args...>;
 
-        struct DecoratorEntry
+        HookPipeline(void* target, void* detour, Hooker* hooker = nullptr)
+            : HookPipelineCore(target, detour, hooker)
         {
-            Node* node = nullptr;
-            std::size_t offset = 0;
-            std::size_t size = 0;
-        };
+        }
 
-        struct InvokedNodeState
+        bool RegisterDecorator(Node* node)
         {
-            Node* node = nullptr;
-            CallContext ctx{};
-        };
+            return Core::RegisterNode(node);
+        }
 
-        HookPipeline(void* target, void* detour)
-            : target_(target), detour_(detour)
+        void UnregisterDecorator(Node* node)
         {
+            Core::UnregisterNode(node);
         }
 
-        bool RegisterDecorator(Node* node)
+        [[nodiscard]] bool IsInstalled() const
         {
-            if (node == nullptr)
-            {
-                return false;
-            }
+            return Core::IsInstalled();
+        }
 
-            {
-                std::lock_guard<std::recursive_mutex> guard{ chain_mtx_ };
-                const auto found = std::find_if(
-                    chain_.begin(),
-                    chain_.end(),
-                    [node](const DecoratorEntry& e)
-                    {
-                        return e.node == node;
-                    });
-                if (found == chain_.end())
-                {
-                    DecoratorEntry entry{};
-                    entry.node = node;
-                    // Defer virtual ContextSize() query until layout rebuild.
-                    // During base construction phase virtual dispatch is not stable.
-                    entry.size = 0;
-                    chain_.push_back(entry);
-                    layout_dirty_ = true;
-                }
-            }
+        bool SetBypass(bool bypass)
+        {
+            return Core::SetBypass(bypass);
+        }
 
-            if (Core::InstallAt(target_, detour_))
-            {
-                return true;
-            }
+        [[nodiscard]] bool IsBypassed() const
+        {
+            return Core::IsBypassed();
+        }
 
-            UnregisterDecorator(node);
-            return false;
+        bool BindLinked(void* original)
+        {
+            return Core::BindLinked(original);
         }
 
-        void UnregisterDecorator(Node* node)
+        bool Activate()
         {
-            if (node == nullptr)
-            {
-                return;
-            }
-            std::lock_guard<std::recursive_mutex> guard{ chain_mtx_ };
-            const auto before = chain_.size();
-            chain_.remove_if(
-                [node](const DecoratorEntry& e)
-                {
-                    return e.node == node;
-                });
-            if (chain_.size() != before)
-            {
-                layout_dirty_ = true;
-            }
+            return Core::Activate();
         }
 
-        [[nodiscard]] bool IsInstalled() const
+        void AwaitTarget()
         {
-            return Core::IsInstalled();
+            Core::AwaitTarget();
         }
 
-        R Dispatch(Args... args)
+        bool ResolveTarget(void* target)
         {
-            std::lock_guard<std::recursive_mutex> guard{ chain_mtx_ };
-            if (chain_.empty())
-            {
-                return CallOriginal(args...);
-            }
+            return Core::ResolveTarget(target);
+        }
 
-            RebuildLayoutIfNeeded();
+        [[nodiscard]] HookPipelineState State() const
+        {
+            return Core::State();
+        }
 
-            auto states = std::tuple<ArgStorageT<Args>...>{ InitArgStorage<Args>(args)... };
-            auto slots = MakeSlots(states, std::index_sequence_for<Args...>{});
-            std::vector<InvokedNodeState> invoked{};
-            invoked.reserve(chain_.size());
+        R Dispatch(Args&&... args)
+        {
+            return DispatchTo<nullptr>(std::forward<Args>(args)...);
+        }
 
-            // One stack arena for this dispatch frame.
-            unsigned char* arena = nullptr;
-            if (arena_bytes_ > 0)
+        // Dispatch for source-expanded targets (expand.h): `Original` is the
+        // renamed definition, known at compile time, so it is called (and can
+        // be inlined) directly instead of through the published trampoline.
+        // nullptr = call through OriginalAddress(), as Dispatch does.
+        template <auto Original>
+        R DispatchTo(Args&&... args)
+        {
+            if (Core::IsBypassed())
             {
-                const std::size_t space = arena_bytes_ + alignof(std::max_align_t);
-                void* aligned = CPPBM_HOOK_ALLOCA(space);
-                arena = static_cast<unsigned char*>(aligned);
+                return CallTo<Original>(std::forward<Args>(args)...);
             }
 
-            bool proceed = true;
-            for (auto it = chain_.begin(); it != chain_.end(); ++it)
+            Core::Frame frame{ *this };
+            if (frame.Empty())
             {
-                auto* node = it->node;
-                if (node == nullptr)
-                {
-                    continue;
-                }
+                return CallTo<Original>(std::forward<Args>(args)...);
+            }
 
-                invoked.emplace_back();
-                auto& state = invoked.back();
-                state.node = node;
-                void* slot_mem = (arena == nullptr || it->size == 0)
-                    ? nullptr
-                    : static_cast<void*>(arena + it->offset);
-                state.ctx = CallContext(slot_mem, it->size);
+            // Slots alias the parameters above; nothing is copied per call,
+            // whether decorators only observe arguments or rewrite them.
+            auto views = std::tuple<ArgViewT<Args>...>{ InitArgView<Args>(args)... };
+            auto slots = MakeSlots(views, std::index_sequence_for<Args...>{});
 
-                if (!InvokeBefore(node, state.ctx, slots))
-                {
-                    proceed = false;
-                    break;
-                }
-            }
+            // alloca must run in this frame; the core only decides the size
+            // (0 = no context or spill to the per-thread arena).
+            const std::size_t stack_bytes = frame.StackBytes();
+            frame.BindArena(stack_bytes > 0 ? CPPBM_HOOK_ALLOCA(stack_bytes) : nullptr);
+
+            const bool proceed = frame.RunBefore(&BeforeThunk, &slots);
 
             if constexpr (std::is_void_v<R>)
             {
                 if (proceed)
                 {
-                    CallOriginalFromStates(states, std::index_sequence_for<Args...>{});
-                }
-
-                for (auto it = invoked.rbegin(); it != invoked.rend(); ++it)
-                {
-                    if (it->node != nullptr)
-                    {
-                        it->node->AfterCallSlot(it->ctx);
-                    }
+                    CallOriginalFromViews<Original>(views, std::index_sequence_for<Args...>{});
                 }
+                frame.RunAfter(&AfterThunk, nullptr);
                 return;
             }
             else
             {
                 R result = proceed
-                    ? CallOriginalFromStates(states, std::index_sequence_for<Args...>{})
+                    ? CallOriginalFromViews<Original>(views, std::index_sequence_for<Args...>{})
                     : HookDefaultReturn<R>();
-
-                for (auto it = invoked.rbegin(); it != invoked.rend(); ++it)
-                {
-                    if (it->node != nullptr)
-                    {
-                        it->node->AfterCallSlot(it->ctx, result);
-                    }
-                }
+                frame.RunAfter(&AfterThunk, const_cast<ResultValue*>(std::addressof(result)));
                 return result;
             }
         }
 
-        R CallOriginal(Args... args) const
+        R CallOriginal(Args&&... args) const
         {
-            OrigFn original = Core::Original();
+            auto original = reinterpret_cast<OrigFn>(Core::OriginalAddress());
             if (original == nullptr)
             {
                 return HookDefaultReturn<R>();
             }
-            return std::invoke(original, args...);
+            return std::invoke(original, std::forward<Args>(args)...);
         }
 
     private:
+        using SlotTuple = std::tuple<ArgSlot<Args>...>;
+        using ResultValue = std::remove_cv_t<std::remove_reference_t<R>>;
+        using ResultPtr = std::add_pointer_t<std::remove_reference_t<R>>;
+
         template <std::size_t... I>
-        static auto MakeSlots(
-            std::tuple<ArgStorageT<Args>...>& states,
+        static SlotTuple MakeSlots(
+            std::tuple<ArgViewT<Args>...>& views,
             std::index_sequence<I...>)
         {
-            return std::tuple<ArgSlot<Args>...>{ ArgSlot<Args>(std::get<I>(states))... };
+            return SlotTuple{ ArgSlot<Args>(std::get<I>(views))... };
         }
 
-        static bool InvokeBefore(
-            Node* node,
-            CallContext& call_ctx,
-            std::tuple<ArgSlot<Args>...>& slots)
+        static bool BeforeThunk(DecoratorNodeBase* node, CallContext& ctx, void* slots)
         {
             return std::apply(
-                [node, &call_ctx](auto&... unpacked_slots) -> bool
+                [node, &ctx](auto&... unpacked_slots) -> bool
                 {
-                    return node->BeforeCallSlot(call_ctx, unpacked_slots...);
+                    return static_cast<Node*>(node)->BeforeCallSlot(ctx, unpacked_slots...);
                 },
-                slots);
+                *static_cast<SlotTuple*>(slots));
         }
 
-        template <std::size_t... I>
-        R CallOriginalFromStates(
-            std::tuple<ArgStorageT<Args>...>& states,
-            std::index_sequence<I...>) const
-        {
-            return CallOriginal(ForwardCallArg<Args>(std::get<I>(states))...);
-        }
-
-        static std::size_t AlignUp(std::size_t value, std::size_t align)
+        static void AfterThunk(DecoratorNodeBase* node, CallContext& ctx, void* result)
         {
-            if (align <= 1)
+            if constexpr (std::is_void_v<R>)
+            {
+                (void)result;
+                static_cast<Node*>(node)->AfterCallSlot(ctx);
+            }
+            else
             {
-                return value;
+                static_cast<Node*>(node)->AfterCallSlot(ctx, *static_cast<ResultPtr>(result));
             }
-            const std::size_t rem = value % align;
-            return rem == 0 ? value : value + (align - rem);
         }
 
-        void RebuildLayoutIfNeeded()
+        template <auto Original>
+        R CallTo(Args&&... args) const
         {
-            if (!layout_dirty_)
+            if constexpr (std::is_null_pointer_v<decltype(Original)>)
             {
-                return;
+                return CallOriginal(std::forward<Args>(args)...);
             }
-
-            std::size_t offset = 0;
-            for (auto& entry : chain_)
+            else
             {
-                entry.size = (entry.node == nullptr) ? 0 : entry.node->ContextSize();
-                if (entry.size == 0)
-                {
-                    entry.offset = 0;
-                    continue;
-                }
-                entry.offset = AlignUp(offset, alignof(std::max_align_t));
-                offset = entry.offset + entry.size;
+                return std::invoke(Original, std::forward<Args>(args)...);
             }
-            arena_bytes_ = offset;
-            layout_dirty_ = false;
         }
 
-    private:
-        void* target_ = nullptr;
-        void* detour_ = nullptr;
-        mutable std::recursive_mutex chain_mtx_{};
-        std::list<DecoratorEntry> chain_{};
-        std::size_t arena_bytes_ = 0;
-        bool layout_dirty_ = false;
+        template <auto Original, std::size_t... I>
+        R CallOriginalFromViews(
+            std::tuple<ArgViewT<Args>...>& views,
+            std::index_sequence<I...>) const
+        {
+            return CallTo<Original>(ForwardCallArg<Args>(std::get<I>(views))...);
+        }
     };
 }
 
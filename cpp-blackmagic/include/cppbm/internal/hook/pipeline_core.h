@@ -0,0 +1,211 @@
+// File role:
+// Signature-independent half of HookPipeline, compiled once into the library
+// (src/internal/hook/pipeline_core.cpp) instead of once per hooked target.
+//
+// Owns:
+// - backend install state (HookState), lazy activation and the runtime
+//   bypass switch
+// - the master decorator chain and its published ChainSnapshot
+// - epoch-based snapshot reclamation
+// - context arena layout and per-dispatch arena binding
+// - the Before... / After... chain walks
+//
+// HookPipeline<OrigFn, R, Args...> keeps only what must be typed: argument
+// views/slots, the two node thunks below, and the call to the original.
+
+#ifndef __CPPBM_HOOK_PIPELINE_CORE_H__
+#define __CPPBM_HOOK_PIPELINE_CORE_H__
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "arena.h"
+#include "node.h"
+#include "state.h"
+#include "../utils/epoch.h"
+#include "../utils/noncopyable.h"
+
+namespace cpp::blackmagic::hook
+{
+    // When a registered decorator gets its target patched.
+    // - Eager: on registration (default).
+    // - Lazy: on the target's first Activate(); until then registration is
+    //   only recorded and the target keeps running unpatched native code.
+    // Read at each registration; build with CPPBM_HOOK_LAZY_INSTALL to start
+    // the process in Lazy mode (covers decorators constructed during static
+    // initialization).
+    enum class HookInstallMode
+    {
+        Eager,
+        Lazy,
+    };
+
+    void SetHookInstallMode(HookInstallMode mode);
+    HookInstallMode GetHookInstallMode();
+
+    // What a pipeline has actually done to its target.
+    enum class HookPipelineState
+    {
+        Idle,       // nothing registered, nothing patched
+        Registered, // decorators recorded, target not patched (lazy, or install failed)
+        Installed,  // patched and dispatching through the chain
+        Bypassed,   // bypass switched on: target runs its original code
+    };
+
+    class HookPipelineCore : private HookState
+    {
+    public:
+        // One decorator's slice of the dispatch arena.
+        struct ContextSlice
+        {
+            std::size_t offset = 0;
+            std::size_t size = 0;
+        };
+
+        // Immutable view of chain_ read by Dispatch, rebuilt only when
+        // registration changes. Node pointers and slices are kept as two
+        // parallel arrays so the Before/After walks stay linear in memory.
+        // Only the slices are filled lazily (once), because virtual
+        // ContextSize() is not stable while decorators are still registering
+        // from base-class constructors.
+        struct ChainSnapshot
+        {
+            std::vector<DecoratorNodeBase*> nodes{};
+            std::vector<ContextSlice> slices{};
+            std::size_t arena_bytes = 0;
+            std::size_t arena_align = 1;
+            std::once_flag layout_once{};
+        };
+
+        // Typed per-target thunks: cast the node back to DecoratorNode<R, Args...>
+        // and call its slot callback. `slots` is the typed ArgSlot tuple,
+        // `result` the typed return value (nullptr for void).
+        using BeforeThunk = bool(*)(DecoratorNodeBase* node, CallContext& ctx, void* slots);
+        using AfterThunk = void(*)(DecoratorNodeBase* node, CallContext& ctx, void* result);
+
+        // One dispatch of one target.
+        //
+        // Lifetime = the hooked call: the epoch read section it holds is what
+        // keeps unregistered nodes alive until After... has run.
+        //
+        // Usage (alloca must run in the typed caller's frame):
+        //   Frame frame{ core };
+        //   if (frame.Empty()) { call original; }
+        //   std::size_t n = frame.StackBytes();
+        //   frame.BindArena(n > 0 ? CPPBM_HOOK_ALLOCA(n) : nullptr);
+        //   bool proceed = frame.RunBefore(before, &slots);
+        //   ...
+        //   frame.RunAfter(after, &result);
+        class Frame : private utils::NonCopyable
+        {
+        public:
+            explicit Frame(HookPipelineCore& core);
+
+            [[nodiscard]] bool Empty() const
+            {
+                return chain_ == nullptr;
+            }
+
+            // Bytes the caller should alloca for this frame's arena
+            // (0 when no context is needed or the arena spills).
+            [[nodiscard]] std::size_t StackBytes() const;
+
+            // Align caller-provided stack memory, or carve the arena from the
+            // per-thread ContextArena when StackBytes() was 0.
+            void BindArena(void* stack_memory);
+
+            // Walk Before... in chain order. Returns false when a node rejected
+            // the call (that node still receives After...).
+            bool RunBefore(BeforeThunk before, void* slots);
+
+            // Walk After... over invoked nodes in reverse order.
+            void RunAfter(AfterThunk after, void* result);
+
+        private:
+            CallContext ContextAt(std::size_t index) const;
+
+            utils::EpochDomain::ReadGuard read_guard_;
+            ChainSnapshot* chain_ = nullptr;
+            unsigned char* arena_ = nullptr;
+            ContextArena::Scope spill_{};
+            std::size_t invoked_ = 0;
+        };
+
+        // `hooker`: target-specific backend, nullptr = Hooker::GetInstance().
+        HookPipelineCore(void* target, void* detour, Hooker* hooker = nullptr);
+        ~HookPipelineCore();
+
+        bool RegisterNode(DecoratorNodeBase* node);
+        void UnregisterNode(DecoratorNodeBase* node);
+
+        // Install now if decorators are registered, and install on every
+        // later registration regardless of HookInstallMode. Idempotent.
+        // Returns false when the backend install failed (see HookError); the
+        // decorators stay registered and Activate() may be retried.
+        bool Activate();
+
+        [[nodiscard]] HookPipelineState State() const;
+
+        // Target known only at runtime (symbol.h): created with a null target,
+        // the pipeline records registrations without installing until
+        // ResolveTarget() supplies the address, then installs as a
+        // registration would (honouring HookInstallMode). AwaitTarget() must
+        // run before the first registration.
+        void AwaitTarget();
+        bool ResolveTarget(void* target);
+
+        // Runtime bypass:
+        // - true: every call runs the original only; the backend patch is
+        //   removed (original prologue restored), so the target runs at
+        //   unhooked speed and the detour is not even entered
+        // - false: re-patch and dispatch through the chain again
+        // Registered decorators stay registered either way.
+        // Returns false when the backend could not switch (see HookError).
+        bool SetBypass(bool bypass);
+
+        // Checked first in Dispatch: covers threads that were already past
+        // the patched prologue when the bypass was switched on.
+        [[nodiscard]] bool IsBypassed() const
+        {
+            return bypass_.load(std::memory_order_acquire);
+        }
+
+        using HookState::BindLinked;
+        using HookState::IsEnabled;
+        using HookState::IsInstalled;
+        using HookState::OriginalAddress;
+
+    private:
+        static void BuildLayout(ChainSnapshot& chain);
+
+        // Build a snapshot from chain_ and swap it in. Caller holds chain_mtx_.
+        // Returns the unpublished snapshot, to be passed to Reclaim() unlocked.
+        ChainSnapshot* PublishLocked();
+
+        // Grace-period wait must not run under chain_mtx_: a dispatching thread
+        // may need that lock (nested Register/Unregister) before it can leave
+        // its read section.
+        void Reclaim(ChainSnapshot* retired);
+
+        // Park an unpublished snapshot without waiting (registration path).
+        void Defer(ChainSnapshot* retired);
+
+        static void DeleteSnapshot(void* snapshot);
+
+    private:
+        // Guarded by chain_mtx_ while awaiting_target_ may change.
+        void* target_ = nullptr;
+        void* detour_ = nullptr;
+        mutable std::mutex chain_mtx_{};
+        bool awaiting_target_ = false;
+        std::vector<DecoratorNodeBase*> chain_{};
+        std::atomic<ChainSnapshot*> snapshot_{ nullptr };
+        std::atomic_bool bypass_{ false };
+        std::atomic_bool activated_{ false };
+        utils::EpochDomain epoch_{};
+    };
+}
+
+#endif // __CPPBM_HOOK_PIPELINE_CORE_H__
@@ -0,0 +1,101 @@
+// File role:
+// Live patching of a running, multi-threaded process
+// (src/internal/hook/quiesce.cpp).
+//
+// A backend that rewrites code normally does so while other threads may be
+// executing it. That is only safe when every hook is installed before those
+// threads start. In StopTheWorld mode, each code write of the backends is
+// wrapped in a PatchQuiescence:
+// 1) every other thread of the process is parked in a signal handler;
+// 2) the interrupted instruction pointers are checked: if one lies strictly
+//    inside bytes about to be rewritten, the threads are resumed, left to
+//    run on briefly, and parked again (up to CPPBM_HOOK_STOP_ATTEMPTS times);
+// 3) the caller writes the whole batch (bytes, protections, cache flush);
+// 4) the threads are resumed. Returning from the signal handler is a
+//    serializing event, so they fetch the new code afterwards.
+// The window contains no allocation and takes no lock a parked thread could
+// hold. Only instruction pointers are checked, not return addresses on the
+// parked threads' stacks.
+//
+// Each pause is measured (GetLivePatchStats) to bound its effect on tail
+// latency. A thread that blocks the stop signal (CPPBM_HOOK_STOP_SIGNAL) and
+// does not park within CPPBM_HOOK_STOP_TIMEOUT_MS fails the write. The hook
+// then reports EnableHookFailed / DisableHookFailed.
+//
+// Coverage: every write made by the native backend and the Dobby backend's
+// enable/disable writes. Dobby writes a new hook's first patch inside
+// DobbyHook() itself, which allocates and so cannot run with the world
+// stopped. MinHook already freezes threads and moves their instruction
+// pointers out of patched bytes on every write, so the mode is a no-op on
+// Windows. So are the plt and vtable hookers: they store one aligned pointer.
+//
+// Linux/Android only. Elsewhere the mode can be set but nothing is stopped.
+
+#ifndef __CPPBM_HOOK_QUIESCE_H__
+#define __CPPBM_HOOK_QUIESCE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "../utils/noncopyable.h"
+
+namespace cpp::blackmagic::hook
+{
+    // How backends write code.
+    // - Direct: in place, while other threads run (default).
+    // - StopTheWorld: inside a PatchQuiescence.
+    // Build with CPPBM_HOOK_STOP_THE_WORLD to start the process in
+    // StopTheWorld mode.
+    enum class LivePatchMode
+    {
+        Direct,
+        StopTheWorld,
+    };
+
+    void SetLivePatchMode(LivePatchMode mode);
+    LivePatchMode GetLivePatchMode();
+
+    // Cumulative since process start; a pause is one park/resume cycle.
+    struct LivePatchStats
+    {
+        std::uint64_t pauses = 0;
+        std::uint64_t retries = 0;       // cycles abandoned: an IP was in the patch
+        std::uint64_t failures = 0;      // writes refused (thread never parked, ...)
+        std::uint64_t last_pause_ns = 0;
+        std::uint64_t max_pause_ns = 0;
+        std::uint64_t total_pause_ns = 0;
+        std::size_t last_threads = 0;    // threads parked by the last pause
+    };
+
+    LivePatchStats GetLivePatchStats();
+
+    // Bytes a backend is about to rewrite.
+    struct PatchRange
+    {
+        const void* begin = nullptr;
+        std::size_t bytes = 0;
+    };
+
+    // Backend side: construct right before the code writes (after every
+    // allocation they need), write only if Safe(), destroy to resume.
+    // In Direct mode this does nothing and Safe() is true.
+    class PatchQuiescence : private utils::NonCopyable
+    {
+    public:
+        PatchQuiescence(const PatchRange* ranges, std::size_t count);
+        ~PatchQuiescence();
+
+        [[nodiscard]] bool Safe() const
+        {
+            return safe_;
+        }
+
+    private:
+        std::unique_lock<std::mutex> session_{};
+        bool stopped_ = false;
+        bool safe_ = true;
+    };
+}
+
+#endif // __CPPBM_HOOK_QUIESCE_H__
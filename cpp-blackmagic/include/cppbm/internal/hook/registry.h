@@ -1,12 +1,18 @@
 #ifndef __CPPBM_HOOK_REGISTRY_H__
 #define __CPPBM_HOOK_REGISTRY_H__
 
+#include <cstddef>
 #include <mutex>
 #include <unordered_map>
 #include <utility>
 
 namespace cpp::blackmagic::hook
 {
+    // Process-wide target -> pipeline table.
+    //
+    // Only used to create (or find) the pipeline for a target once, and for
+    // enumeration. Hook bases cache the returned reference per Target, so the
+    // per-call detour path never takes mtx_.
     class HookPipelineRegistry
     {
     public:
@@ -33,8 +39,25 @@ namespace cpp::blackmagic::hook
             return *created;
         }
 
+        [[nodiscard]] std::size_t Size() const
+        {
+            std::lock_guard<std::mutex> guard{ mtx_ };
+            return pipelines_.size();
+        }
+
+        // Visit every (target, type-erased pipeline) pair.
+        template <typename Fn>
+        void ForEach(Fn&& fn) const
+        {
+            std::lock_guard<std::mutex> guard{ mtx_ };
+            for (const auto& [target, pipeline] : pipelines_)
+            {
+                fn(target, pipeline);
+            }
+        }
+
     private:
-        std::mutex mtx_{};
+        mutable std::mutex mtx_{};
         std::unordered_map<const void*, void*> pipelines_{};
     };
 
@@ -4,6 +4,7 @@
 #include <atomic>
 #include <mutex>
 
+#include "batch.h"
 #include "error.h"
 #include "hooker.h"
 #include "../utils/noncopyable.h"
@@ -16,14 +17,27 @@ namespace cpp::blackmagic::hook
     // 1) Ensure CreateHook/EnableHook runs once.
     // 2) Store original trampoline pointer.
     // 3) Publish install status atomically.
+    // 4) Switch the installed patch off/on at runtime (EnableHook/DisableHook).
+    // 5) Defer the enable to the open HookBatch, if any (see batch.h).
+    // 6) Accept a build-time hook instead of a backend one (BindLinked).
+    // 7) Use a target-specific backend instead of the process-wide one, if
+    //    given (vtable slots, see vtable.h).
     //
     // Not handled here:
     // - decorator chain ordering
     // - argument rewriting / dispatch logic
-    template <typename OrigFn>
+    //
+    // Signature-independent: the trampoline is kept as void* and typed pipelines
+    // cast it back to their own function-pointer type.
     class HookState : private utils::NonCopyable
     {
     public:
+        // nullptr = the process-wide backend, Hooker::GetInstance().
+        explicit HookState(Hooker* hooker = nullptr)
+            : hooker_(hooker)
+        {
+        }
+
         bool InstallAt(void* target, void* detour)
         {
             std::lock_guard<std::mutex> guard{ mtx_ };
@@ -43,9 +57,9 @@ namespace cpp::blackmagic::hook
                     });
             }
 
-            Hooker& hooker = Hooker::GetInstance();
-            OrigFn original = nullptr;
-            if (!hooker.CreateHook(target, detour, reinterpret_cast<void**>(&original)))
+            Hooker& hooker = Backend();
+            void* original = nullptr;
+            if (!hooker.CreateHook(target, detour, &original))
             {
                 return HandleHookFailure(HookError{
                     HookErrorCode::CreateHookFailed,
@@ -55,6 +69,18 @@ namespace cpp::blackmagic::hook
                     });
             }
 
+            // Inside a batch the patch goes live at commit; the trampoline is
+            // published now, before any thread can reach the detour. Batches
+            // only queue on the process-wide backend.
+            if (hooker_ == nullptr && enabled_.load(std::memory_order_acquire) && HookBatch::GetInstance().Defer(this, target))
+            {
+                original_.store(original, std::memory_order_release);
+                target_ = target;
+                queued_ = true;
+                installed_.store(true, std::memory_order_release);
+                return true;
+            }
+
             if (!hooker.EnableHook(target))
             {
                 hooker.RemoveHook(target);
@@ -67,7 +93,83 @@ namespace cpp::blackmagic::hook
             }
 
             original_.store(original, std::memory_order_release);
+            target_ = target;
             installed_.store(true, std::memory_order_release);
+
+            // Disabled before install: keep the trampoline, drop the patch.
+            if (!enabled_.load(std::memory_order_acquire) && !hooker.DisableHook(target))
+            {
+                enabled_.store(true, std::memory_order_release);
+                return HandleHookFailure(HookError{
+                    HookErrorCode::DisableHookFailed,
+                    target,
+                    detour,
+                    "Hook install failed: backend DisableHook() returned false."
+                    });
+            }
+            return true;
+        }
+
+        // Build-time hook (linker --wrap, see link_wrap.h; source expansion,
+        // see expand.h): calls already reach the detour, so there is nothing to
+        // patch. Publish the real definition as the original and never involve
+        // the backend for this target. A backend patch installed earlier (a
+        // decorator registered from another translation unit's static
+        // initializer) is removed first.
+        bool BindLinked(void* original)
+        {
+            std::lock_guard<std::mutex> guard{ mtx_ };
+            if (linked_)
+            {
+                return original_.load(std::memory_order_acquire) == original;
+            }
+            if (installed_.load(std::memory_order_acquire))
+            {
+                if (queued_ || !Backend().RemoveHook(target_))
+                {
+                    return false;
+                }
+                target_ = nullptr;
+            }
+            original_.store(original, std::memory_order_release);
+            linked_ = true;
+            installed_.store(true, std::memory_order_release);
+            return true;
+        }
+
+        // Patch (true) or restore (false) the target's original code.
+        // The trampoline stays valid either way, so Original() keeps working.
+        // Before install only the wanted state is recorded.
+        bool SetEnabled(bool enabled)
+        {
+            std::lock_guard<std::mutex> guard{ mtx_ };
+            if (enabled_.load(std::memory_order_acquire) == enabled)
+            {
+                return true;
+            }
+            // Not installed yet, or still queued in a batch: the wanted state
+            // is applied by install / batch completion. Linked targets have no
+            // patch; their bypass is the pipeline flag alone.
+            if (!installed_.load(std::memory_order_acquire) || queued_ || linked_)
+            {
+                enabled_.store(enabled, std::memory_order_release);
+                return true;
+            }
+
+            ClearLastHookError();
+            Hooker& hooker = Backend();
+            if (enabled ? !hooker.EnableHook(target_) : !hooker.DisableHook(target_))
+            {
+                return HandleHookFailure(HookError{
+                    enabled ? HookErrorCode::EnableHookFailed : HookErrorCode::DisableHookFailed,
+                    target_,
+                    nullptr,
+                    enabled
+                        ? "Hook enable failed: backend EnableHook() returned false."
+                        : "Hook disable failed: backend DisableHook() returned false."
+                    });
+            }
+            enabled_.store(enabled, std::memory_order_release);
             return true;
         }
 
@@ -76,15 +178,62 @@ namespace cpp::blackmagic::hook
             return installed_.load(std::memory_order_acquire);
         }
 
+        [[nodiscard]] bool IsEnabled() const
+        {
+            return enabled_.load(std::memory_order_acquire);
+        }
+
     protected:
-        OrigFn Original() const
+        void* OriginalAddress() const
         {
             return original_.load(std::memory_order_acquire);
         }
 
     private:
-        std::atomic<OrigFn> original_{ nullptr };
+        friend class HookBatch;
+
+        Hooker& Backend() const
+        {
+            return hooker_ != nullptr ? *hooker_ : Hooker::GetInstance();
+        }
+
+        // Called by HookBatch once the queued enable has been applied (or has
+        // failed, in which case the hook is removed again). Returns false when
+        // a bypass requested meanwhile could not be honoured.
+        bool CompleteQueued(bool applied)
+        {
+            std::lock_guard<std::mutex> guard{ mtx_ };
+            if (!queued_)
+            {
+                return true;
+            }
+            queued_ = false;
+
+            Hooker& hooker = Backend();
+            if (!applied)
+            {
+                hooker.RemoveHook(target_);
+                installed_.store(false, std::memory_order_release);
+                original_.store(nullptr, std::memory_order_release);
+                target_ = nullptr;
+                return true;
+            }
+
+            if (!enabled_.load(std::memory_order_acquire) && !hooker.DisableHook(target_))
+            {
+                enabled_.store(true, std::memory_order_release);
+                return false;
+            }
+            return true;
+        }
+
+        Hooker* hooker_ = nullptr;
+        std::atomic<void*> original_{ nullptr };
         std::atomic_bool installed_{ false };
+        std::atomic_bool enabled_{ true };
+        void* target_ = nullptr;
+        bool queued_ = false;
+        bool linked_ = false;
         mutable std::mutex mtx_{};
     };
 }
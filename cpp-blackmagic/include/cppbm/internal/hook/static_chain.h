@@ -0,0 +1,484 @@
+// File role:
+// Compile-time fused decorator chains.
+//
+// HookPipeline reaches each decorator through a DecoratorNode* and pays up to
+// three virtual calls per phase:
+//   BeforeCallSlot -> BeforeCall(ctx, args...) -> BeforeCall(args...)
+//
+// When every decorator on a target is known at preprocess time, the chain is
+// instead instantiated over the concrete decorator types:
+// - StaticNodeCall walks the callback cascade with qualified calls on the
+//   concrete type, so each step binds to its final overrider at compile time
+//   and can be inlined
+// - StaticChainNode owns the decorators by value and registers itself as ONE
+//   node into the dynamic HookPipeline, which stays the fallback for any
+//   decorator attached at runtime (ordering across both is preserved); the
+//   members are constructed without registering themselves, so installing a
+//   chain publishes one snapshot and never waits for a grace period
+//
+// A cascade step falls back to a virtual call only when the concrete type
+// hides the overload it needs (e.g. it declares BeforeCall(args...) but not
+// BeforeCall(ctx, args...)); `using FunctionDecorator<T>::BeforeCall;` in the
+// decorator keeps that step static as well. BindStaticChain rejects such
+// decorators at compile time (see BindsStatically).
+
+#ifndef __CPPBM_HOOK_STATIC_CHAIN_H__
+#define __CPPBM_HOOK_STATIC_CHAIN_H__
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "node.h"
+
+namespace cpp::blackmagic::hook
+{
+    // Which class qualified lookup on a concrete decorator resolves one
+    // callback to.
+    enum class StaticStep
+    {
+        Inherited,  // DecoratorNode default: skip straight to the next step
+        Overridden, // declared below DecoratorNode: qualified call is exact
+        Hidden      // not visible by qualified lookup: virtual fallback
+    };
+
+    // Chain members are constructed by the chain, which registers them as one
+    // node. While a StaticChainMembers scope is open on a thread, the next
+    // `count` FunctionDecorator constructions for `pipeline` Claim() a slot
+    // and skip their own registration (their destructors then find nothing
+    // to unregister).
+    class StaticChainMembers
+    {
+    public:
+        StaticChainMembers(const void* pipeline, std::size_t count)
+            : prev_(Current())
+        {
+            Current() = Pending{ pipeline, count };
+        }
+
+        ~StaticChainMembers()
+        {
+            Current() = prev_;
+        }
+
+        StaticChainMembers(const StaticChainMembers&) = delete;
+        StaticChainMembers& operator=(const StaticChainMembers&) = delete;
+
+        static bool Claim(const void* pipeline)
+        {
+            Pending& pending = Current();
+            if (pending.pipeline != pipeline || pending.count == 0)
+            {
+                return false;
+            }
+            --pending.count;
+            return true;
+        }
+
+    private:
+        struct Pending
+        {
+            const void* pipeline = nullptr;
+            std::size_t count = 0;
+        };
+
+        static Pending& Current()
+        {
+            static thread_local Pending pending{};
+            return pending;
+        }
+
+        Pending prev_{};
+    };
+
+    // After... callbacks take the result as a trailing R& parameter, or no
+    // parameter for void targets. Both shapes share one implementation that
+    // spells that tail as Result&... with Result = {R} or {}.
+    template <typename Node>
+    struct StaticResultTail;
+
+    template <typename R, typename... Args>
+    struct StaticResultTail<DecoratorNode<R, Args...>>
+    {
+        using type = std::tuple<R>;
+    };
+
+    template <typename... Args>
+    struct StaticResultTail<DecoratorNode<void, Args...>>
+    {
+        using type = std::tuple<>;
+    };
+
+    template <typename Node, typename Results = typename StaticResultTail<Node>::type>
+    struct StaticNodeCall;
+
+    template <typename R, typename... Args, typename... Result>
+    struct StaticNodeCall<DecoratorNode<R, Args...>, std::tuple<Result...>>
+    {
+        using Node = DecoratorNode<R, Args...>;
+
+        // Owner-class probes. Deducing C from an overload set picks the one
+        // overload with the probed signature and yields its declaring class.
+        template <typename C>
+        static C* SlotBeforeOwner(bool (C::*)(CallContext&, ArgSlot<Args>&...));
+
+        template <typename C>
+        static C* CtxBeforeOwner(bool (C::*)(CallContext&, Args&...));
+
+        template <typename C>
+        static C* SlotAfterOwner(void (C::*)(CallContext&, Result&...));
+
+        template <typename C>
+        static C* CtxAfterOwner(void (C::*)(CallContext&, Result&...));
+
+        template <typename Owner>
+        static constexpr StaticStep StepOf()
+        {
+            return std::is_same_v<Owner, Node*> ? StaticStep::Inherited : StaticStep::Overridden;
+        }
+
+        template <typename D>
+        static constexpr StaticStep SlotBeforeStep()
+        {
+            if constexpr (requires { SlotBeforeOwner(&D::BeforeCallSlot); })
+            {
+                return StepOf<decltype(SlotBeforeOwner(&D::BeforeCallSlot))>();
+            }
+            else
+            {
+                return StaticStep::Hidden;
+            }
+        }
+
+        template <typename D>
+        static constexpr StaticStep CtxBeforeStep()
+        {
+            if constexpr (requires { CtxBeforeOwner(&D::BeforeCall); })
+            {
+                return StepOf<decltype(CtxBeforeOwner(&D::BeforeCall))>();
+            }
+            else
+            {
+                return StaticStep::Hidden;
+            }
+        }
+
+        template <typename D>
+        static constexpr StaticStep SlotAfterStep()
+        {
+            if constexpr (requires { SlotAfterOwner(&D::AfterCallSlot); })
+            {
+                return StepOf<decltype(SlotAfterOwner(&D::AfterCallSlot))>();
+            }
+            else
+            {
+                return StaticStep::Hidden;
+            }
+        }
+
+        template <typename D>
+        static constexpr StaticStep CtxAfterStep()
+        {
+            if constexpr (requires { CtxAfterOwner(&D::AfterCall); })
+            {
+                return StepOf<decltype(CtxAfterOwner(&D::AfterCall))>();
+            }
+            else
+            {
+                return StaticStep::Hidden;
+            }
+        }
+
+        // Whether both phases of D reach its callbacks without a virtual call.
+        template <typename D>
+        static constexpr bool BindsStatically()
+        {
+            constexpr StaticStep slot_before = SlotBeforeStep<D>();
+            constexpr StaticStep slot_after = SlotAfterStep<D>();
+            const bool before = slot_before == StaticStep::Overridden
+                || (slot_before == StaticStep::Inherited && CtxBeforeStep<D>() != StaticStep::Hidden);
+            const bool after = slot_after == StaticStep::Overridden
+                || (slot_after == StaticStep::Inherited && CtxAfterStep<D>() != StaticStep::Hidden);
+            return before && after;
+        }
+
+        template <typename D>
+        static bool Before(D& d, CallContext& ctx, ArgSlot<Args>&... slots)
+        {
+            constexpr StaticStep step = SlotBeforeStep<D>();
+            if constexpr (step == StaticStep::Overridden)
+            {
+                return d.D::BeforeCallSlot(ctx, slots...);
+            }
+            else if constexpr (step == StaticStep::Hidden)
+            {
+                return static_cast<Node&>(d).BeforeCallSlot(ctx, slots...);
+            }
+            else
+            {
+                return BeforeCtx(d, ctx, slots.BeforeArg()...);
+            }
+        }
+
+        template <typename D>
+        static bool BeforeCtx(D& d, CallContext& ctx, Args&... args)
+        {
+            constexpr StaticStep step = CtxBeforeStep<D>();
+            if constexpr (step == StaticStep::Overridden)
+            {
+                return d.D::BeforeCall(ctx, args...);
+            }
+            else if constexpr (step == StaticStep::Hidden)
+            {
+                return static_cast<Node&>(d).BeforeCall(ctx, args...);
+            }
+            else if constexpr (requires { d.D::BeforeCall(args...); })
+            {
+                return d.D::BeforeCall(args...);
+            }
+            else
+            {
+                return static_cast<Node&>(d).BeforeCall(args...);
+            }
+        }
+
+        template <typename D>
+        static void After(D& d, CallContext& ctx, Result&... result)
+        {
+            constexpr StaticStep step = SlotAfterStep<D>();
+            if constexpr (step == StaticStep::Overridden)
+            {
+                d.D::AfterCallSlot(ctx, result...);
+            }
+            else if constexpr (step == StaticStep::Hidden)
+            {
+                static_cast<Node&>(d).AfterCallSlot(ctx, result...);
+            }
+            else
+            {
+                AfterCtx(d, ctx, result...);
+            }
+        }
+
+        template <typename D>
+        static void AfterCtx(D& d, CallContext& ctx, Result&... result)
+        {
+            constexpr StaticStep step = CtxAfterStep<D>();
+            if constexpr (step == StaticStep::Overridden)
+            {
+                d.D::AfterCall(ctx, result...);
+            }
+            else if constexpr (step == StaticStep::Hidden)
+            {
+                static_cast<Node&>(d).AfterCall(ctx, result...);
+            }
+            else if constexpr (requires { d.D::AfterCall(result...); })
+            {
+                d.D::AfterCall(result...);
+            }
+            else
+            {
+                static_cast<Node&>(d).AfterCall(result...);
+            }
+        }
+    };
+
+    // Shared state of one fused chain: decorator objects, context layout and
+    // the Before walk. HookBase is the target's hook bridge (it provides
+    // GetPipeline and Register/UnregisterDecoratorNode).
+    //
+    // Context slice of the fused node:
+    //   [ invoked count ][ decorator 0 slice ][ decorator 1 slice ] ...
+    // packed at each decorator's ContextAlign(); the fused node reports the
+    // largest of them, so every sub-slice stays aligned in the arena.
+    // The invoked count lives in the per-call arena, so nested and concurrent
+    // calls each see their own value.
+    template <typename HookBase, typename Node, typename... Decorators>
+    class StaticChainCore;
+
+    template <typename HookBase, typename R, typename... Args, typename... Decorators>
+    class StaticChainCore<HookBase, DecoratorNode<R, Args...>, Decorators...> : public HookBase
+    {
+    public:
+        using Node = DecoratorNode<R, Args...>;
+        using Call = StaticNodeCall<Node>;
+
+        static constexpr std::size_t kCount = sizeof...(Decorators);
+
+        std::size_t ContextSize() const override
+        {
+            return bytes_;
+        }
+
+        std::size_t ContextAlign() const override
+        {
+            return align_;
+        }
+
+        bool BeforeCallSlot(CallContext& ctx, ArgSlot<Args>&... slots) override
+        {
+            auto* invoked = ctx.As<std::size_t>();
+            if (invoked == nullptr)
+            {
+                return true;
+            }
+            *invoked = 0;
+            return BeforeFrom<0>(ctx, *invoked, slots...);
+        }
+
+    protected:
+        StaticChainCore() = default;
+        ~StaticChainCore() = default;
+
+        // Decorator members were constructed unregistered (MakeMembers):
+        // compute the layout, then register the fused node in their place.
+        void AttachChain()
+        {
+            BuildLayout(std::index_sequence_for<Decorators...>{});
+            (void)this->RegisterDecoratorNode();
+        }
+
+        // Must run before decorators_ is destroyed: returns only once no
+        // in-flight dispatch can still reach them.
+        void DetachChain()
+        {
+            this->UnregisterDecoratorNode();
+        }
+
+        template <std::size_t I>
+        CallContext SliceOf(const CallContext& ctx) const
+        {
+            if (sizes_[I] == 0)
+            {
+                return CallContext{};
+            }
+            return CallContext(static_cast<unsigned char*>(ctx.Data()) + offsets_[I], sizes_[I]);
+        }
+
+        template <std::size_t I>
+        auto& DecoratorAt()
+        {
+            return std::get<I>(decorators_);
+        }
+
+    private:
+        template <std::size_t I>
+        bool BeforeFrom(CallContext& ctx, std::size_t& invoked, ArgSlot<Args>&... slots)
+        {
+            if constexpr (I == kCount)
+            {
+                return true;
+            }
+            else
+            {
+                CallContext slice = SliceOf<I>(ctx);
+                // Counted before the call: a rejecting decorator still gets After.
+                ++invoked;
+                if (!Call::Before(std::get<I>(decorators_), slice, slots...))
+                {
+                    return false;
+                }
+                return BeforeFrom<I + 1>(ctx, invoked, slots...);
+            }
+        }
+
+        // Guaranteed elision: the tuple is built in place, with every member's
+        // self-registration claimed by the chain.
+        static std::tuple<Decorators...> MakeMembers()
+        {
+            StaticChainMembers members{ &HookBase::GetPipeline(), kCount };
+            return std::tuple<Decorators...>{};
+        }
+
+        static std::size_t AlignUp(std::size_t value, std::size_t align)
+        {
+            const std::size_t rem = value % align;
+            return rem == 0 ? value : value + (align - rem);
+        }
+
+        template <std::size_t... I>
+        void BuildLayout(std::index_sequence<I...>)
+        {
+            // Qualified calls: the dynamic type of each member is exact.
+            sizes_ = { std::get<I>(decorators_).Decorators::ContextSize()... };
+            const std::array<std::size_t, kCount> aligns{
+                NormalizeContextAlign(std::get<I>(decorators_).Decorators::ContextAlign())...
+            };
+            std::size_t offset = sizeof(std::size_t);
+            for (std::size_t i = 0; i < kCount; ++i)
+            {
+                if (sizes_[i] == 0)
+                {
+                    offsets_[i] = 0;
+                    continue;
+                }
+                offsets_[i] = AlignUp(offset, aligns[i]);
+                offset = offsets_[i] + sizes_[i];
+                align_ = aligns[i] > align_ ? aligns[i] : align_;
+            }
+            bytes_ = offset;
+        }
+
+        std::tuple<Decorators...> decorators_ = MakeMembers();
+        std::array<std::size_t, kCount> offsets_{};
+        std::array<std::size_t, kCount> sizes_{};
+        std::size_t bytes_ = sizeof(std::size_t);
+        std::size_t align_ = alignof(std::size_t);
+    };
+
+    // Fused node: one registration, one virtual Before/After pair per call for
+    // the whole chain, statically bound calls for every decorator inside it.
+    template <typename HookBase, typename Node, typename Results, typename... Decorators>
+    class StaticChainNodeImpl;
+
+    template <typename HookBase, typename R, typename... Args, typename... Result, typename... Decorators>
+    class StaticChainNodeImpl<HookBase, DecoratorNode<R, Args...>, std::tuple<Result...>, Decorators...> final
+        : public StaticChainCore<HookBase, DecoratorNode<R, Args...>, Decorators...>
+    {
+        using Core = StaticChainCore<HookBase, DecoratorNode<R, Args...>, Decorators...>;
+
+    public:
+        StaticChainNodeImpl()
+        {
+            this->AttachChain();
+        }
+
+        ~StaticChainNodeImpl()
+        {
+            this->DetachChain();
+        }
+
+        void AfterCallSlot(CallContext& ctx, Result&... result) override
+        {
+            const auto* invoked = ctx.As<std::size_t>();
+            if (invoked != nullptr)
+            {
+                AfterReverse(ctx, *invoked, std::index_sequence_for<Decorators...>{}, result...);
+            }
+        }
+
+    private:
+        template <std::size_t... I>
+        void AfterReverse(CallContext& ctx, std::size_t invoked, std::index_sequence<I...>, Result&... result)
+        {
+            (AfterAt<Core::kCount - 1 - I>(ctx, invoked, result...), ...);
+        }
+
+        template <std::size_t I>
+        void AfterAt(CallContext& ctx, std::size_t invoked, Result&... result)
+        {
+            if (I < invoked)
+            {
+                CallContext slice = this->template SliceOf<I>(ctx);
+                Core::Call::After(this->template DecoratorAt<I>(), slice, result...);
+            }
+        }
+    };
+
+    template <typename HookBase, typename Node, typename... Decorators>
+    using StaticChainNode = StaticChainNodeImpl<HookBase, Node, typename StaticResultTail<Node>::type, Decorators...>;
+}
+
+#endif // __CPPBM_HOOK_STATIC_CHAIN_H__
@@ -0,0 +1,207 @@
+// File role:
+// Decorator targets named at runtime: a library, a symbol and a C++
+// signature, for code in modules the program loads later (plugins).
+//
+//   class Timing : public SymbolDecorator<int(int)>
+//   {
+//   public:
+//       Timing() : SymbolDecorator("libplugin.so", "PluginWork") {}
+//       bool BeforeCall(int& v) override { ... }
+//   };
+//
+// Each (library, symbol, signature) gets one typed HookPipeline, created on
+// first use with no target. Registrations are recorded; the address is
+// resolved with dlsym() once the library is loaded, and only then installed
+// through the process-wide backend. Loads are noticed once any target is
+// pending: on Linux/Android through a GOT-level dlopen() interception (the
+// plt hooker, so libc's own code is never patched), on Apple through dyld's
+// image-added callback. Elsewhere, or after loading some other way, call
+// RescanSymbolTargets().
+//
+// Detours: a pipeline's detour cannot be named by a compile-time Target, so
+// each signature owns a fixed pool of CPPBM_HOOK_SYMBOL_SLOTS detours, one per
+// runtime target of that signature. A target beyond the pool is reported as
+// DetourPoolExhausted.
+//
+// A resolved library is pinned (its dlopen() reference is kept): the patch
+// must not outlive the code it was written into.
+
+#ifndef __CPPBM_HOOK_SYMBOL_H__
+#define __CPPBM_HOOK_SYMBOL_H__
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "hook.h"
+#include "../utils/noncopyable.h"
+
+#ifndef CPPBM_HOOK_SYMBOL_SLOTS
+#define CPPBM_HOOK_SYMBOL_SLOTS 32
+#endif
+
+namespace cpp::blackmagic::hook
+{
+    // Signature-independent table of runtime targets, compiled into the
+    // library (src/internal/hook/symbol.cpp).
+    class SymbolTargets : private utils::NonCopyable
+    {
+    public:
+        // Typed per-signature callbacks:
+        // - create the pipeline for pool slot `index` (already awaiting its target)
+        // - hand a resolved address to that pipeline
+        using CreateFn = void* (*)(std::size_t index);
+        using ResolveFn = bool (*)(void* pipeline, void* address);
+
+        static SymbolTargets& GetInstance();
+
+        // Pipeline for (library, symbol, signature), created on first use and
+        // resolved right away when the library is already loaded. nullptr when
+        // the signature's detour pool is exhausted (see HookError).
+        // `library` nullptr or "" = any loaded object (dlsym(RTLD_DEFAULT)).
+        void* Acquire(
+            const char* library,
+            const char* symbol,
+            const void* signature,
+            std::size_t slots,
+            CreateFn create,
+            ResolveFn resolve);
+
+        // Resolve every pending target whose library is now loaded.
+        // Returns how many were resolved by this call.
+        std::size_t Rescan();
+
+        [[nodiscard]] std::size_t Pending() const;
+
+    private:
+        struct Entry
+        {
+            std::string library{};
+            std::string symbol{};
+            const void* signature = nullptr;
+            void* pipeline = nullptr;
+            ResolveFn resolve = nullptr;
+            bool resolved = false;
+        };
+
+        SymbolTargets() = default;
+
+        // Start noticing library loads (first pending target). Must not be
+        // called with mtx_ held: it may rescan right away.
+        void WatchLoads();
+
+        mutable std::mutex mtx_{};
+        // Stable addresses: Entry pointers are kept across Rescan().
+        std::vector<std::unique_ptr<Entry>> entries_{};
+        std::once_flag watch_once_{};
+    };
+
+    inline std::size_t RescanSymbolTargets()
+    {
+        return SymbolTargets::GetInstance().Rescan();
+    }
+
+    template <typename R, typename... Args>
+    class SymbolPipelines
+    {
+    public:
+        using Fn = R(*)(Args...);
+        using Pipeline = HookPipeline<Fn, R, Args...>;
+
+        static constexpr std::size_t kSlots = CPPBM_HOOK_SYMBOL_SLOTS;
+
+        static Pipeline* Get(const char* library, const char* symbol)
+        {
+            return static_cast<Pipeline*>(SymbolTargets::GetInstance().Acquire(
+                library, symbol, &signature_, kSlots, &Create, &Resolve));
+        }
+
+    private:
+        template <std::size_t I>
+        static R Detour(Args... args)
+        {
+            return pipelines_[I].load(std::memory_order_acquire)->Dispatch(std::forward<Args>(args)...);
+        }
+
+        template <std::size_t... I>
+        static constexpr std::array<Fn, kSlots> MakeDetours(std::index_sequence<I...>)
+        {
+            return { &Detour<I>... };
+        }
+
+        static constexpr std::array<Fn, kSlots> kDetours = MakeDetours(std::make_index_sequence<kSlots>{});
+
+        // Published before the target can be installed, so a detour always
+        // finds its pipeline.
+        static void* Create(std::size_t index)
+        {
+            Pipeline& pipeline = GetOrCreateHookPipeline<Pipeline>(
+                &pipelines_[index],
+                nullptr,
+                reinterpret_cast<void*>(kDetours[index]));
+            pipeline.AwaitTarget();
+            pipelines_[index].store(&pipeline, std::memory_order_release);
+            return &pipeline;
+        }
+
+        static bool Resolve(void* pipeline, void* address)
+        {
+            return static_cast<Pipeline*>(pipeline)->ResolveTarget(address);
+        }
+
+        // Identity of the signature: one object per instantiation.
+        static inline const char signature_ = 0;
+        static inline std::array<std::atomic<Pipeline*>, kSlots> pipelines_{};
+    };
+
+    // Bridge for decorators on a runtime target; counterpart of FreeHookBase.
+    template <typename Fn>
+    class SymbolHookBase;
+
+    template <typename R, typename... Args>
+    class SymbolHookBase<R(Args...)> : public DecoratorNode<R, Args...>, private utils::NonCopyable
+    {
+    public:
+        using Pipeline = typename SymbolPipelines<R, Args...>::Pipeline;
+
+        SymbolHookBase(const char* library, const char* symbol)
+            : pipeline_(SymbolPipelines<R, Args...>::Get(library, symbol))
+        {
+        }
+
+        // nullptr when the signature's detour pool was exhausted.
+        [[nodiscard]] Pipeline* GetPipeline() const
+        {
+            return pipeline_;
+        }
+
+    protected:
+        R CallOriginal(Args... args) const
+        {
+            return pipeline_->CallOriginal(std::forward<Args>(args)...);
+        }
+
+        bool RegisterDecoratorNode()
+        {
+            return pipeline_ != nullptr && pipeline_->RegisterDecorator(this);
+        }
+
+        void UnregisterDecoratorNode()
+        {
+            if (pipeline_ != nullptr)
+            {
+                pipeline_->UnregisterDecorator(this);
+            }
+        }
+
+    private:
+        Pipeline* pipeline_ = nullptr;
+    };
+}
+
+#endif // __CPPBM_HOOK_SYMBOL_H__
@@ -0,0 +1,101 @@
+// File role:
+// Vtable-slot hooking for virtual member functions.
+//
+// A pointer to a virtual member function carries a vtable offset, not a code
+// address, so it cannot be inline-patched; and patching the implementation
+// would decorate every class that inherits it. Instead MemberHookBase hooks
+// the slot of the class named in the member pointer type:
+//   FunctionDecorator<&Square::Area>   // objects of dynamic type Square only
+//   FunctionDecorator<&Shape::Area>    // Shape objects only, not Square or
+//                                      // any class inheriting Shape::Area
+// Installing is one pointer store into that class's vtable; calls through the
+// vtable then reach the detour with `this` exactly as the caller passed it,
+// and the original is the implementation the slot held.
+//
+// Scope:
+// - Itanium C++ ABI (GCC/Clang) on ELF (Linux/Android). Elsewhere virtual
+//   targets are not recognized and keep the inline backend.
+// - the function must be reachable through the class's primary vtable
+//   (no `this` adjustment in the member pointer).
+// - only calls dispatched through the vtable are decorated: qualified calls
+//   (obj.Square::Area()) and calls the compiler devirtualized reach the
+//   implementation directly.
+// - objects whose dynamic type is a class derived from the hooked one use
+//   their own vtable and are not decorated.
+
+#ifndef __CPPBM_HOOK_VTABLE_H__
+#define __CPPBM_HOOK_VTABLE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <typeinfo>
+
+#include "hooker.h"
+
+#if !defined(_MSC_VER) && (defined(__GNUC__) || defined(__clang__))
+#define CPPBM_HOOK_ITANIUM_ABI
+#endif
+
+namespace cpp::blackmagic::hook
+{
+    // Backend for vtable slots: target = address of the slot. Independent of
+    // the process-wide Hooker::GetInstance() backend and always available.
+    Hooker& GetVtableHooker();
+
+    // Address point of the primary vtable of `type` (the value stored in the
+    // vptr of objects of exactly that type), or nullptr when it cannot be
+    // found. Located through the vtable's RTTI field; results are cached.
+    void** FindVtable(const std::type_info& type);
+
+    struct VirtualTarget
+    {
+        bool is_virtual = false;
+        // nullptr when the target is virtual but its slot could not be resolved.
+        void** slot = nullptr;
+    };
+
+    template <typename Class, typename MemFn>
+        requires std::is_member_function_pointer_v<MemFn>
+    VirtualTarget ResolveVirtualTarget(MemFn fn)
+    {
+#ifdef CPPBM_HOOK_ITANIUM_ABI
+        if constexpr (std::is_polymorphic_v<Class>)
+        {
+            // { ptr, adj }: ptr = 1 + vtable offset for virtual functions,
+            // except on ARM, where the flag is the low bit of adj.
+            struct Representation
+            {
+                std::uintptr_t ptr;
+                std::ptrdiff_t adj;
+            };
+            static_assert(sizeof(MemFn) == sizeof(Representation));
+            Representation rep{};
+            std::memcpy(&rep, &fn, sizeof(rep));
+#if defined(__arm__) || defined(__aarch64__)
+            const bool is_virtual = (rep.adj & 1) != 0;
+            const std::uintptr_t offset = rep.ptr;
+            const std::ptrdiff_t this_adjust = rep.adj >> 1;
+#else
+            const bool is_virtual = (rep.ptr & 1) != 0;
+            const std::uintptr_t offset = rep.ptr - 1;
+            const std::ptrdiff_t this_adjust = rep.adj;
+#endif
+            if (!is_virtual)
+            {
+                return {};
+            }
+            void** vtable = this_adjust == 0 ? FindVtable(typeid(Class)) : nullptr;
+            return VirtualTarget{
+                true,
+                vtable != nullptr ? vtable + offset / sizeof(void*) : nullptr,
+            };
+        }
+#endif
+        (void)fn;
+        return {};
+    }
+}
+
+#endif // __CPPBM_HOOK_VTABLE_H__
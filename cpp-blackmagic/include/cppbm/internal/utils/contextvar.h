@@ -143,9 +143,11 @@ namespace cpp::blackmagic::utils
             {
                 slots_[this] = token.previous_;
             }
-            else
+            else if (auto it = slots_.find(this); it != slots_.end())
             {
-                slots_.erase(this);
+                // Keep the node: a var set and restored on every call (an
+                // @inject top-level scope) would otherwise allocate each time.
+                it->second.reset();
             }
         }
     };
@@ -0,0 +1,235 @@
+// File role:
+// Minimal epoch-based read/reclaim primitive (userspace RCU style).
+//
+// Design goals:
+// 1) Read side is lock-free: one atomic increment/decrement per critical section,
+//    on a counter stripe picked per thread, so threads calling the same target
+//    do not share a cache line.
+// 2) Writers publish a new immutable snapshot, then Synchronize() (which scans
+//    every stripe) before reclaiming the old one.
+// 3) Re-entrant: a thread that writes while it is itself inside a read section
+//    of the same domain never waits; reclamation is deferred instead.
+//
+// Usage model:
+//   reader: EpochDomain::ReadGuard guard{ domain }; auto* p = ptr.load(...);
+//   writer: old = ptr.exchange(next); domain.Retire(old, deleter);
+//   writer that must not wait: domain.Defer(old, deleter);
+
+#ifndef __CPPBM_UTILS_EPOCH_H__
+#define __CPPBM_UTILS_EPOCH_H__
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "noncopyable.h"
+
+// Reader counter stripes per domain (power of two). Threads are spread over
+// them round-robin; more threads than stripes share lines again.
+#ifndef CPPBM_EPOCH_STRIPES
+#define CPPBM_EPOCH_STRIPES 16
+#endif
+
+namespace cpp::blackmagic::utils
+{
+    class EpochDomain : private NonCopyable
+    {
+    public:
+        using Deleter = void(*)(void*);
+
+        class ReadGuard : private NonCopyable
+        {
+        public:
+            explicit ReadGuard(const EpochDomain& domain)
+                : domain_(&domain),
+                prev_(TopFrame())
+            {
+                // Epoch value only selects a counter; correctness comes from the
+                // seq_cst increment being ordered before the snapshot load.
+                const unsigned parity = domain.epoch_.load(std::memory_order_relaxed) & 1u;
+                counter_ = &domain.stripes_[ThreadStripe() % kStripes].count[parity];
+                counter_->fetch_add(1, std::memory_order_seq_cst);
+                TopFrame() = this;
+            }
+
+            ~ReadGuard()
+            {
+                TopFrame() = prev_;
+                counter_->fetch_sub(1, std::memory_order_release);
+            }
+
+        private:
+            friend class EpochDomain;
+
+            const EpochDomain* domain_ = nullptr;
+            const ReadGuard* prev_ = nullptr;
+            std::atomic<std::size_t>* counter_ = nullptr;
+        };
+
+        EpochDomain() = default;
+
+        ~EpochDomain()
+        {
+            FreeRetired(retired_);
+        }
+
+        // Wait until every read section that could have observed a snapshot
+        // unpublished before this call has finished.
+        // Must not be called from inside a read section of this domain.
+        void Synchronize() const
+        {
+            std::lock_guard<std::mutex> guard{ sync_mtx_ };
+            for (int phase = 0; phase < 2; ++phase)
+            {
+                const unsigned old = epoch_.load(std::memory_order_relaxed) & 1u;
+                epoch_.store(old ^ 1u, std::memory_order_seq_cst);
+                for (std::size_t i = 0; i < kStripes; ++i)
+                {
+                    while (stripes_[i].count[old].load(std::memory_order_seq_cst) != 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        }
+
+        // Reclaim one unpublished snapshot after a grace period.
+        //
+        // A thread that is itself inside a read section of this domain must not
+        // wait (another writer may be waiting for that very frame), so nested
+        // calls only park the pointer; the next Retire() issued from outside any
+        // read section frees everything parked so far.
+        void Retire(void* ptr, Deleter deleter)
+        {
+            if (HasOwnFrames())
+            {
+                Defer(ptr, deleter);
+                return;
+            }
+
+            Synchronize();
+
+            std::vector<Retired> ready{};
+            {
+                std::lock_guard<std::mutex> guard{ retire_mtx_ };
+                ready.swap(retired_);
+            }
+            if (ptr != nullptr)
+            {
+                ready.push_back(Retired{ ptr, deleter });
+            }
+            FreeRetired(ready);
+        }
+
+        // Park one unpublished snapshot without waiting for readers.
+        //
+        // If no read section is open right now, everything parked so far is
+        // freed on the spot (one scan, no wait), so a run of registrations with
+        // no concurrent calls keeps O(1) snapshots alive. Otherwise it is freed
+        // by a later Defer() that finds the domain idle, the next Retire()
+        // issued outside a read section, or with the domain.
+        void Defer(void* ptr, Deleter deleter)
+        {
+            if (ptr == nullptr)
+            {
+                return;
+            }
+            std::vector<Retired> ready{};
+            {
+                std::lock_guard<std::mutex> guard{ retire_mtx_ };
+                retired_.push_back(Retired{ ptr, deleter });
+                if (!HasOwnFrames() && IsIdle())
+                {
+                    ready.swap(retired_);
+                }
+            }
+            FreeRetired(ready);
+        }
+
+        // Whether the calling thread currently holds a read section of this domain.
+        [[nodiscard]] bool HasOwnFrames() const
+        {
+            for (const ReadGuard* frame = TopFrame(); frame != nullptr; frame = frame->prev_)
+            {
+                if (frame->domain_ == this)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        static constexpr std::size_t kStripes = CPPBM_EPOCH_STRIPES;
+        static_assert(kStripes > 0 && (kStripes & (kStripes - 1)) == 0,
+            "CPPBM_EPOCH_STRIPES must be a power of two.");
+
+        struct Retired
+        {
+            void* ptr = nullptr;
+            Deleter deleter = nullptr;
+        };
+
+        // Readers hit these counters on every call: one cache line per stripe,
+        // holding both epoch parities.
+        struct alignas(64) ReaderStripe
+        {
+            std::atomic<std::size_t> count[2]{};
+        };
+
+        static const ReadGuard*& TopFrame()
+        {
+            static thread_local const ReadGuard* top = nullptr;
+            return top;
+        }
+
+        // Stripe of the calling thread, assigned round-robin on first use.
+        static std::size_t ThreadStripe()
+        {
+            static std::atomic<std::size_t> next{ 0 };
+            static thread_local const std::size_t stripe = next.fetch_add(1, std::memory_order_relaxed);
+            return stripe;
+        }
+
+        // Non-blocking grace check: no reader in either epoch on any stripe.
+        // Everything parked was unpublished before this scan; a reader that
+        // enters after its stripe was read loads the current snapshot (its
+        // seq_cst increment orders before its snapshot load), so an all-zero
+        // scan is a full grace period for the parked list.
+        bool IsIdle() const
+        {
+            for (std::size_t i = 0; i < kStripes; ++i)
+            {
+                if (stripes_[i].count[0].load(std::memory_order_seq_cst) != 0
+                    || stripes_[i].count[1].load(std::memory_order_seq_cst) != 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static void FreeRetired(std::vector<Retired>& list)
+        {
+            for (auto& entry : list)
+            {
+                if (entry.deleter != nullptr)
+                {
+                    entry.deleter(entry.ptr);
+                }
+            }
+            list.clear();
+        }
+
+        mutable ReaderStripe stripes_[kStripes]{};
+        mutable std::atomic<unsigned> epoch_{ 0 };
+        mutable std::mutex sync_mtx_{};
+        std::mutex retire_mtx_{};
+        std::vector<Retired> retired_{};
+    };
+}
+
+#endif // __CPPBM_UTILS_EPOCH_H__
@@ -38,8 +38,41 @@ function(_CPPBM_GET_RELATIVE_SOURCE_PATH ABS TARGET OUT_REL)
 	set(${OUT_REL} "${REL}" PARENT_SCOPE)
 endfunction()
 
+# Pass the --wrap options recorded by CPPBM_LINK_WRAP glue in TARGET's
+# objects to its link (response file written at PRE_LINK by link_wrap.py).
+function(CPPBM_LINK_WRAP_OPTIONS)
+	set(oneValueArgs TARGET)
+	cmake_parse_arguments(WRAP "" "${oneValueArgs}" "" ${ARGN})
+
+	if(NOT WRAP_TARGET)
+		message(FATAL_ERROR "CPPBM_LINK_WRAP_OPTIONS: TARGET is required")
+	endif()
+
+	get_filename_component(LINK_WRAP_SCRIPT
+		"${CMAKE_CURRENT_FUNCTION_LIST_DIR}/../link_wrap.py"
+		ABSOLUTE
+	)
+	set(RSP "${CMAKE_BINARY_DIR}/cppbm-gen/${WRAP_TARGET}.wrap.rsp")
+
+	add_custom_command(TARGET ${WRAP_TARGET} PRE_LINK
+		COMMAND "${CPPBM_PYTHON_EXECUTABLE}" "${LINK_WRAP_SCRIPT}"
+			--out "${RSP}"
+			"$<TARGET_OBJECTS:${WRAP_TARGET}>"
+		COMMAND_EXPAND_LISTS
+		VERBATIM
+	)
+	target_link_options(${WRAP_TARGET} PRIVATE "LINKER:@${RSP}")
+endfunction()
+
 function(CPPBM_ENABLE_DECORATOR)
-	set(options)
+	# STATIC_CHAIN: fuse all decorators of one function into a compile-time
+	# chain (binders must provide BindStatic<&Target>(...)).
+	# LINK_WRAP: hook free functions defined in TARGET's sources with linker
+	# --wrap glue instead of runtime patching (ELF, x86-64/AArch64, executables).
+	# EXPAND: rename decorated free function definitions and forward the
+	# original name through the pipeline in source; no hook backend involved.
+	# Targets that cannot be expanded fall back to LINK_WRAP or runtime hooks.
+	set(options STATIC_CHAIN LINK_WRAP EXPAND)
 	set(oneValueArgs TARGET)
 	set(multiValueArgs MODULES)
 	cmake_parse_arguments(DECOR "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
@@ -74,6 +107,18 @@ function(CPPBM_ENABLE_DECORATOR)
 		string(REPLACE ";" "," DECORATOR_MODULES_ARG "${DECOR_MODULES}")
 	endif()
 
+	set(DECORATOR_EXTRA_ARGS "")
+	if(DECOR_STATIC_CHAIN)
+		list(APPEND DECORATOR_EXTRA_ARGS --static-chain)
+	endif()
+	if(DECOR_EXPAND)
+		list(APPEND DECORATOR_EXTRA_ARGS --expand)
+	endif()
+	if(DECOR_LINK_WRAP)
+		list(APPEND DECORATOR_EXTRA_ARGS --link-wrap)
+		CPPBM_LINK_WRAP_OPTIONS(TARGET ${DECOR_TARGET})
+	endif()
+
 	get_target_property(RAW_SOURCES ${DECOR_TARGET} SOURCES)
 	if(NOT RAW_SOURCES)
 		message(FATAL_ERROR "Target '${DECOR_TARGET}' has no SOURCES")
@@ -98,6 +143,7 @@ function(CPPBM_ENABLE_DECORATOR)
 					--in "${ABS}"
 					--out "${OUT}"
 					--modules "${DECORATOR_MODULES_ARG}"
+					${DECORATOR_EXTRA_ARGS}
 				DEPENDS "${ABS}" "${DECORATOR_SCRIPT}" ${DECORATOR_MODULE_DEPENDS}
 				COMMENT "Decorator preprocess ${REL}"
 				VERBATIM
@@ -0,0 +1,77 @@
+# Text-size report for built binaries (run with cmake -P).
+#
+# Inputs:
+#   SIZE_TOOL  path to binutils/llvm `size`
+#   FILES      binaries, separated by '|'
+#   OUTPUT     report file to write ("<text bytes> <name>" per line)
+#   BASELINE   optional earlier report; prints per-binary deltas against it
+#
+# Typical before/after comparison:
+#   1) build the old tree, run the cppbm-size-report target, keep the report
+#   2) rebuild with -DCPPBM_SIZE_BASELINE=<kept report>, run it again
+
+if(NOT SIZE_TOOL OR NOT FILES OR NOT OUTPUT)
+	message(FATAL_ERROR "size_report.cmake: SIZE_TOOL, FILES and OUTPUT are required")
+endif()
+
+string(REPLACE "|" ";" FILE_LIST "${FILES}")
+
+set(BASE_NAMES "")
+set(BASE_SIZES "")
+if(BASELINE AND EXISTS "${BASELINE}")
+	file(STRINGS "${BASELINE}" BASE_LINES)
+	foreach(LINE IN LISTS BASE_LINES)
+		if(LINE MATCHES "^([0-9]+) (.+)$")
+			list(APPEND BASE_SIZES "${CMAKE_MATCH_1}")
+			list(APPEND BASE_NAMES "${CMAKE_MATCH_2}")
+		endif()
+	endforeach()
+endif()
+
+set(REPORT "")
+set(TOTAL 0)
+set(BASE_TOTAL 0)
+set(MATCHED_TOTAL 0)
+message(STATUS "cpp-blackmagic text size report")
+foreach(BINARY IN LISTS FILE_LIST)
+	get_filename_component(NAME "${BINARY}" NAME_WE)
+	if(NOT EXISTS "${BINARY}")
+		message(STATUS "  ${NAME}: not built, skipped")
+		continue()
+	endif()
+
+	# Berkeley format: header line, then "text data bss dec hex filename".
+	execute_process(
+		COMMAND "${SIZE_TOOL}" "${BINARY}"
+		OUTPUT_VARIABLE SIZE_OUT
+		RESULT_VARIABLE SIZE_RC
+	)
+	if(NOT SIZE_RC EQUAL 0 OR NOT SIZE_OUT MATCHES "\n[ \t]*([0-9]+)")
+		message(STATUS "  ${NAME}: size tool failed, skipped")
+		continue()
+	endif()
+	set(TEXT "${CMAKE_MATCH_1}")
+	string(APPEND REPORT "${TEXT} ${NAME}\n")
+	math(EXPR TOTAL "${TOTAL} + ${TEXT}")
+
+	list(FIND BASE_NAMES "${NAME}" BASE_INDEX)
+	if(BASE_INDEX GREATER_EQUAL 0)
+		list(GET BASE_SIZES ${BASE_INDEX} BASE_TEXT)
+		math(EXPR DELTA "${TEXT} - ${BASE_TEXT}")
+		math(EXPR BASE_TOTAL "${BASE_TOTAL} + ${BASE_TEXT}")
+		math(EXPR MATCHED_TOTAL "${MATCHED_TOTAL} + ${TEXT}")
+		message(STATUS "  ${NAME}: text=${TEXT} baseline=${BASE_TEXT} delta=${DELTA}")
+	else()
+		message(STATUS "  ${NAME}: text=${TEXT}")
+	endif()
+endforeach()
+
+if(BASE_TOTAL GREATER 0)
+	math(EXPR TOTAL_DELTA "${MATCHED_TOTAL} - ${BASE_TOTAL}")
+	message(STATUS "  total: text=${TOTAL} delta=${TOTAL_DELTA} (over binaries present in the baseline)")
+else()
+	message(STATUS "  total: text=${TOTAL}")
+endif()
+
+file(WRITE "${OUTPUT}" "${REPORT}")
+message(STATUS "report written to ${OUTPUT}")
@@ -5,7 +5,17 @@ Responsibilities:
 1) Remove `decorator(...)` macro markers while preserving source layout.
 2) Append generated Bind registrations:
    inline auto __cppbm_dec_xxx = (expr).Bind<&Target>();
-3) Run optional module handlers around generation (`handle`).
+   or, in static-chain mode (--static-chain), one fused chain per target:
+   inline auto __cppbm_chain_xxx = BindStaticChain<&Target>(
+       (expr1).BindStatic<&Target>(), (expr2).BindStatic<&Target>());
+3) In link-wrap mode (--link-wrap), emit CPPBM_LINK_WRAP glue for every
+   eligible target, so it is hooked by the linker (--wrap) instead of by
+   runtime patching.
+4) In expand mode (--expand), rename every eligible decorated definition to
+   `__cppbm_orig_xxx` and define a forwarding wrapper under the original
+   name that enters the pipeline directly (see hook/expand.h): no runtime
+   patching at all. Takes precedence over link-wrap for the same target.
+5) Run optional module handlers around generation (`handle`).
 """
 
 import argparse
@@ -167,6 +177,24 @@ class DecoratorBinding:
     # - future router module may append an invoker meta object
     meta_args: List[str]
     sentence: str
+    # Free function defined in this file: can be hooked with linker --wrap.
+    link_wrap_eligible: bool = False
+    # Source rewrite for expand mode; None when the target is not eligible.
+    expansion: Optional["Expansion"] = None
+
+
+@dataclass
+class Expansion:
+    # Byte offsets into the masked source.
+    type_start: int
+    name_start: int
+    name_end: int
+    header_start: int
+    body_start: int
+    end: int
+    param_names: List[str]
+    # `= value` of each default argument, dropped from the wrapper definition.
+    default_ranges: List[Tuple[int, int]]
 
 
 @dataclass
@@ -478,6 +506,126 @@ def render_binding_sentence(binding: DecoratorBinding) -> str:
     return wrap_sentence_in_namespace(binding.namespace_scope, core_sentence)
 
 
+def render_static_chain_sentence(bindings: List[DecoratorBinding]) -> str:
+    # Static-chain mode: all bindings of one target (declaration order) are
+    # fused into one BindStaticChain<&Target>(...) call. Each decorator still
+    # receives its own metadata through BindStatic<&Target>(metas...).
+    head = bindings[0]
+    var_name = head.var_name.replace("__cppbm_dec_", "__cppbm_chain_", 1)
+    specs = []
+    for binding in bindings:
+        if len(binding.meta_args) == 0:
+            specs.append(f"    ({binding.expr}).BindStatic<&{binding.target}>()")
+        else:
+            args = ",\n".join(f"        {arg}" for arg in binding.meta_args)
+            specs.append(
+                f"    ({binding.expr}).BindStatic<&{binding.target}>(\n"
+                f"{args}\n"
+                "    )"
+            )
+    specs_text = ",\n".join(specs)
+    core_sentence = (
+        f"inline auto {var_name} = "
+        f"::cpp::blackmagic::BindStaticChain<&{head.target}>(\n"
+        f"{specs_text}\n"
+        ");"
+    )
+    return wrap_sentence_in_namespace(head.namespace_scope, core_sentence)
+
+
+def render_link_wrap_sentence(binding: DecoratorBinding) -> str:
+    # The glue must live in the defining translation unit: there &Target is
+    # the real definition, which the linker does not redirect.
+    name = binding.var_name.replace("__cppbm_dec_", "__cppbm_link_", 1)
+    core_sentence = f"CPPBM_LINK_WRAP({name}, (&{binding.target}))"
+    return wrap_sentence_in_namespace(binding.namespace_scope, core_sentence)
+
+
+def is_link_wrap_eligible(func: dict) -> bool:
+    # Definitions only (a declaration's &Target would itself be wrapped), with
+    # one external definition (inline/static/constexpr would emit the wrapper
+    # in every including TU, or have no cross-object reference to wrap), and
+    # no class scope (member functions keep runtime patching).
+    if func.get("node_type") != "function_definition":
+        return False
+    if any(spec in ("inline", "static", "constexpr", "consteval") for spec in func.get("specifiers", [])):
+        return False
+    scope = func["fullname"].rsplit("::", 1)[0] if "::" in func["fullname"] else ""
+    return scope == func.get("namespace_scope", "")
+
+
+def make_expansion(func: dict) -> Optional[Expansion]:
+    # Out-of-line free function definitions only: the wrapper must be able to
+    # redeclare the exact header under the same unqualified name. Templates,
+    # extern "C" blocks, constexpr, unnamed or C-variadic parameters and
+    # qualified names keep the runtime hook.
+    expand = func.get("expand")
+    if expand is None or func.get("node_type") != "function_definition":
+        return None
+    if any(spec in ("constexpr", "consteval") for spec in func.get("specifiers", [])):
+        return None
+    scope = func["fullname"].rsplit("::", 1)[0] if "::" in func["fullname"] else ""
+    if scope != func.get("namespace_scope", ""):
+        return None
+    return Expansion(**expand)
+
+
+def render_expansion_edits(binding: DecoratorBinding, code: bytes) -> List[Tuple[int, int, bytes]]:
+    # Keeps the line layout: the original header is first redeclared on its
+    # own line (so the renamed body still sees the name, e.g. to recurse
+    # through the decorators), and the wrapper is appended after the
+    # original's closing brace. Default arguments stay on that declaration.
+    exp = binding.expansion
+    name = binding.target.rsplit("::", 1)[-1]
+    orig = f"__cppbm_orig_{name}"
+    header = code[exp.header_start:exp.body_start].decode("utf-8").rstrip()
+    definition = code[exp.header_start:exp.body_start]
+    for start, end in sorted(exp.default_ranges, reverse=True):
+        definition = definition[:start - exp.header_start] + definition[end - exp.header_start:]
+    definition = definition.decode("utf-8").rstrip()
+    forwarded = ", ".join(f"static_cast<decltype({p})&&>({p})" for p in exp.param_names)
+    wrapper = (
+        f" {definition} {{ return ::cpp::blackmagic::hook::Expanded<&{name}, &{orig}>::Call({forwarded}); }}"
+    )
+    static_prefix = b"" if "static" in code[exp.header_start:exp.type_start].decode("utf-8").split() else b"static "
+    # Edits at one offset apply in list order, each in front of the previous.
+    return [
+        (exp.type_start, exp.type_start, static_prefix),
+        (exp.header_start, exp.header_start, f"{header}; ".encode("utf-8")),
+        (exp.name_start, exp.name_end, orig.encode("utf-8")),
+        (exp.end, exp.end, wrapper.encode("utf-8")),
+    ]
+
+
+def render_expand_sentence(binding: DecoratorBinding) -> str:
+    name = binding.target.rsplit("::", 1)[-1]
+    var = binding.var_name.replace("__cppbm_dec_", "__cppbm_expand_", 1)
+    core_sentence = (
+        f"[[maybe_unused]] static const bool {var} = "
+        f"::cpp::blackmagic::hook::Expanded<&{name}, &__cppbm_orig_{name}>::Bind();"
+    )
+    return wrap_sentence_in_namespace(binding.namespace_scope, core_sentence)
+
+
+def apply_byte_edits(text: str, edits: List[Tuple[int, int, bytes]]) -> str:
+    code = text.encode("utf-8")
+    for start, end, replacement in sorted(edits, key=lambda e: (e[0], e[1]), reverse=True):
+        code = code[:start] + replacement + code[end:]
+    return code.decode("utf-8")
+
+
+def group_bindings_by_target(bindings: List[DecoratorBinding]) -> List[List[DecoratorBinding]]:
+    groups: Dict[Tuple[str, str], List[DecoratorBinding]] = {}
+    order: List[Tuple[str, str]] = []
+    for binding in bindings:
+        key = (binding.namespace_scope, binding.target)
+        if key not in groups:
+            groups[key] = []
+            order.append(key)
+        groups[key].append(binding)
+    return [groups[key] for key in order]
+
+
 def get_function_info(func_node, code):
     declarator_node = func_node.child_by_field_name("declarator")
     if not declarator_node:
@@ -587,6 +735,56 @@ def get_function_info(func_node, code):
                 param_types.append("...")
             param_index += 1
 
+    specifiers = [
+        code[child.start_byte:child.end_byte].decode("utf-8", errors="ignore").strip()
+        for child in func_node.children
+        if child.type in ["storage_class_specifier", "type_qualifier", "virtual"]
+    ]
+
+    # Positions for expand mode (see make_expansion).
+    expand = None
+    type_node = func_node.child_by_field_name("type")
+    body_node = func_node.child_by_field_name("body")
+    param_names: Optional[List[str]] = []
+    default_ranges: List[Tuple[int, int]] = []
+    for child in parameter_list_node.children:
+        if child.type == "optional_parameter_declaration":
+            eq_node = next((c for c in child.children if c.type == "="), None)
+            if eq_node is not None:
+                default_ranges.append((eq_node.start_byte, child.end_byte))
+        if child.type in ["parameter_declaration", "optional_parameter_declaration"]:
+            if child.child_by_field_name("declarator") is None and get_node_text(child, code) == "void":
+                continue
+            name_node = find_first_descendant_by_type(child.child_by_field_name("declarator"), "identifier")
+            if name_node is None:
+                param_names = None
+                break
+            param_names.append(get_node_text(name_node, code))
+        elif child.type in ["variadic_parameter", "variadic_parameter_declaration"]:
+            param_names = None
+            break
+    parent_type = func_node.parent.type if func_node.parent is not None else ""
+    if (
+        func_node.type == "function_definition"
+        and type_node is not None
+        and body_node is not None
+        and body_node.type == "compound_statement"
+        and func_name_node.type == "identifier"
+        and param_names is not None
+        and parent_type in ["translation_unit", "declaration_list"]
+        and (parent_type == "translation_unit" or func_node.parent.parent.type == "namespace_definition")
+    ):
+        expand = {
+            "type_start": type_node.start_byte,
+            "name_start": func_name_node.start_byte,
+            "name_end": func_name_node.end_byte,
+            "header_start": func_node.start_byte,
+            "body_start": body_node.start_byte,
+            "end": func_node.end_byte,
+            "param_names": param_names,
+            "default_ranges": default_ranges,
+        }
+
     return {
         "name": func_name,
         "fullname": fullname,
@@ -597,6 +795,8 @@ def get_function_info(func_node, code):
         "param_count": param_index,
         "param_types": param_types,
         "param_defaults": param_defaults,
+        "specifiers": specifiers,
+        "expand": expand,
     }
 
 
@@ -699,6 +899,24 @@ def main():
         default="",
         help="Comma-separated decorator modules, e.g. inject",
     )
+    p.add_argument(
+        "--static-chain",
+        dest="static_chain",
+        action="store_true",
+        help="Fuse all decorators of one target into a compile-time chain",
+    )
+    p.add_argument(
+        "--link-wrap",
+        dest="link_wrap",
+        action="store_true",
+        help="Hook free functions defined here through linker --wrap glue",
+    )
+    p.add_argument(
+        "--expand",
+        dest="expand",
+        action="store_true",
+        help="Rename decorated definitions and call the pipeline from a source-level wrapper",
+    )
     args = p.parse_args()
 
     src = Path(args.inp)
@@ -760,6 +978,8 @@ def main():
             target_param_types=list(func.get("param_types", [])),
             meta_args=[],
             sentence="",
+            link_wrap_eligible=is_link_wrap_eligible(func),
+            expansion=make_expansion(func),
         )
         binding.sentence = render_binding_sentence(binding)
         context.bindings.append(binding)
@@ -769,14 +989,53 @@ def main():
     for binding in context.bindings:
         binding.sentence = render_binding_sentence(binding)
 
+    sentences = [binding.sentence for binding in context.bindings]
+    if args.static_chain:
+        sentences = []
+        for group in group_bindings_by_target(context.bindings):
+            print(f"[decorator] static-chain {group[0].target} ({len(group)} decorators)")
+            sentences.append(render_static_chain_sentence(group))
+
+    expanded_targets = set()
+    if args.expand:
+        edits = []
+        expand_sentences = []
+        for group in group_bindings_by_target(context.bindings):
+            head = group[0]
+            if head.expansion is None:
+                print(f"[decorator] expand skipped {head.target} (not an out-of-line free function definition), runtime hook")
+                continue
+            print(f"[decorator] expand {head.target}")
+            edits.extend(render_expansion_edits(head, masked.encode("utf-8")))
+            expand_sentences.append(render_expand_sentence(head))
+            expanded_targets.add((head.namespace_scope, head.target))
+        masked = apply_byte_edits(masked, edits)
+        # Ahead of the bindings, which may register decorators.
+        sentences = expand_sentences + sentences
+
+    if args.link_wrap:
+        link_sentences = []
+        for group in group_bindings_by_target(context.bindings):
+            head = group[0]
+            if (head.namespace_scope, head.target) in expanded_targets:
+                continue
+            if not head.link_wrap_eligible:
+                print(f"[decorator] link-wrap skipped {head.target} (not a free function defined here), runtime hook")
+                continue
+            print(f"[decorator] link-wrap {head.target}")
+            link_sentences.append(render_link_wrap_sentence(head))
+        if len(link_sentences) > 0:
+            # Ahead of the bindings, which may register decorators.
+            sentences = ["#include <cppbm/internal/hook/link_wrap.h>"] + link_sentences + sentences
+
     if len(context.bindings) > 0 or len(context.generated_prefix_lines) > 0 or len(context.generated_suffix_lines) > 0:
         masked += "\n\n\n// Generated decorator bindings.\n"
         for line in context.generated_prefix_lines:
             masked += line + "\n"
         if len(context.generated_prefix_lines) > 0 and len(context.bindings) > 0:
             masked += "\n"
-        for binding in context.bindings:
-            masked += binding.sentence + "\n"
+        for sentence in sentences:
+            masked += sentence + "\n"
         if len(context.generated_suffix_lines) > 0 and len(context.bindings) > 0:
             masked += "\n"
         for line in context.generated_suffix_lines:
@@ -0,0 +1,92 @@
+"""
+Link-wrap option pass (link_wrap.py), run at PRE_LINK.
+
+Responsibilities:
+1) Read the `.cppbm_wrap` section of every object file given on the command
+   line (written by CPPBM_LINK_WRAP, see include/cppbm/internal/hook/link_wrap.h).
+   Each entry is one NUL-terminated mangled symbol name.
+2) Write one `--wrap=<symbol>` per line to the response file passed to the
+   linker as `-Wl,@<file>`.
+"""
+
+import argparse
+import struct
+from pathlib import Path
+from typing import List
+
+SECTION_NAME = b".cppbm_wrap"
+
+
+def read_elf_section(raw: bytes, wanted: bytes) -> bytes:
+    if len(raw) < 16 or raw[:4] != b"\x7fELF":
+        return b""
+
+    is_64 = raw[4] == 2
+    endian = "<" if raw[5] == 1 else ">"
+    if is_64:
+        shoff, = struct.unpack_from(endian + "Q", raw, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", raw, 0x3A)
+        sh_fmt = endian + "IIQQQQIIQQ"
+    else:
+        shoff, = struct.unpack_from(endian + "I", raw, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", raw, 0x2E)
+        sh_fmt = endian + "IIIIIIIIII"
+
+    if shoff == 0 or shnum == 0:
+        return b""
+
+    def section(index: int):
+        fields = struct.unpack_from(sh_fmt, raw, shoff + index * shentsize)
+        # name, type, flags, addr, offset, size, ...
+        return fields[0], fields[4], fields[5]
+
+    _, names_off, names_size = section(shstrndx)
+    names = raw[names_off:names_off + names_size]
+
+    out = b""
+    for index in range(shnum):
+        name_off, off, size = section(index)
+        end = names.find(b"\0", name_off)
+        if names[name_off:end] == wanted:
+            out += raw[off:off + size]
+    return out
+
+
+def collect_symbols(objects: List[str]) -> List[str]:
+    symbols: List[str] = []
+    seen = set()
+    for obj in objects:
+        path = Path(obj)
+        if not path.exists():
+            continue
+        payload = read_elf_section(path.read_bytes(), SECTION_NAME)
+        for entry in payload.split(b"\0"):
+            if not entry:
+                continue
+            name = entry.decode("ascii")
+            if name in seen:
+                continue
+            seen.add(name)
+            symbols.append(name)
+    return symbols
+
+
+def main():
+    p = argparse.ArgumentParser()
+    p.add_argument("--out", dest="out", required=True)
+    p.add_argument("objects", nargs="*")
+    args = p.parse_args()
+
+    symbols = collect_symbols(args.objects)
+    text = "".join(f"--wrap={name}\n" for name in symbols)
+
+    out = Path(args.out)
+    out.parent.mkdir(parents=True, exist_ok=True)
+    if not out.exists() or out.read_text() != text:
+        out.write_text(text)
+    for name in symbols:
+        print(f"[link_wrap] --wrap={name}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,111 @@
+// Process-wide hook install batch.
+#include <utility>
+
+#include "cppbm/internal/hook/batch.h"
+#include "cppbm/internal/hook/state.h"
+
+namespace cpp::blackmagic::hook
+{
+    HookBatch& HookBatch::GetInstance()
+    {
+        static HookBatch instance{};
+        return instance;
+    }
+
+    HookBatch::HookBatch()
+    {
+#ifdef CPPBM_HOOK_BATCH_STARTUP
+        // Decorators constructed during static initialization all queue into
+        // this batch; InstallAll() (e.g. first thing in main) applies it.
+        depth_ = 1;
+#endif
+    }
+
+    void HookBatch::Begin()
+    {
+        std::lock_guard<std::mutex> guard{ mtx_ };
+        ++depth_;
+    }
+
+    bool HookBatch::Commit()
+    {
+        std::unique_lock<std::mutex> lock{ mtx_ };
+        if (depth_ == 0)
+        {
+            return true;
+        }
+        if (--depth_ != 0)
+        {
+            return true;
+        }
+        return ApplyLocked(lock);
+    }
+
+    bool HookBatch::CommitAll()
+    {
+        std::unique_lock<std::mutex> lock{ mtx_ };
+        depth_ = 0;
+        return ApplyLocked(lock);
+    }
+
+    bool HookBatch::IsOpen() const
+    {
+        std::lock_guard<std::mutex> guard{ mtx_ };
+        return depth_ != 0;
+    }
+
+    bool HookBatch::Defer(HookState* state, void* target)
+    {
+        std::lock_guard<std::mutex> guard{ mtx_ };
+        if (depth_ == 0 || !Hooker::GetInstance().QueueEnableHook(target))
+        {
+            return false;
+        }
+        pending_.push_back(state);
+        return true;
+    }
+
+    bool HookBatch::ApplyLocked(std::unique_lock<std::mutex>& lock)
+    {
+        if (pending_.empty())
+        {
+            return true;
+        }
+
+        ClearLastHookError();
+        // Applied under mtx_, so no Defer() can queue into a pass that is
+        // already being written.
+        const bool applied = Hooker::GetInstance().ApplyQueued();
+        std::vector<HookState*> pending = std::move(pending_);
+        pending_.clear();
+        lock.unlock();
+
+        // HookState locks its own mutex while holding none of ours (InstallAt
+        // takes them in the opposite order).
+        bool complete = true;
+        for (HookState* state : pending)
+        {
+            complete = state->CompleteQueued(applied) && complete;
+        }
+
+        if (!applied)
+        {
+            return HandleHookFailure(HookError{
+                HookErrorCode::EnableHookFailed,
+                nullptr,
+                nullptr,
+                "Hook batch commit failed: backend ApplyQueued() returned false; batch rolled back."
+                });
+        }
+        if (!complete)
+        {
+            return HandleHookFailure(HookError{
+                HookErrorCode::DisableHookFailed,
+                nullptr,
+                nullptr,
+                "Hook batch commit failed: backend DisableHook() returned false for a bypassed target."
+                });
+        }
+        return true;
+    }
+}
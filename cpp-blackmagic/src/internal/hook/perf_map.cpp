@@ -0,0 +1,327 @@
+// Profiler symbols for generated hook code (see perf_map.h).
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#define CPPBM_PERF_MAP_OUTPUT 1
+#endif
+
+#include "cppbm/internal/hook/perf_map.h"
+
+namespace cpp::blackmagic::hook
+{
+    namespace
+    {
+        // Only what the backend hands over: names are resolved when a region
+        // is written out, so installs pay nothing while output is off.
+        struct Region
+        {
+            std::uintptr_t code = 0;
+            std::size_t size = 0;
+            const void* target = nullptr;
+            const char* role = nullptr;
+        };
+
+        PerfMapMode ModeFromEnvironment()
+        {
+            const char* value = std::getenv("CPPBM_PERF_MAP");
+            if (value == nullptr)
+            {
+                return PerfMapMode::Off;
+            }
+            if (std::strcmp(value, "jitdump") == 0)
+            {
+                return PerfMapMode::JitDump;
+            }
+            if (std::strcmp(value, "1") == 0 || std::strcmp(value, "map") == 0)
+            {
+                return PerfMapMode::Map;
+            }
+            return PerfMapMode::Off;
+        }
+
+#ifdef CPPBM_PERF_MAP_OUTPUT
+        std::string TargetName(const void* target)
+        {
+            Dl_info info{};
+            if (dladdr(target, &info) != 0)
+            {
+                if (info.dli_sname != nullptr && info.dli_saddr == target)
+                {
+                    int status = -1;
+                    char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+                    std::string name = status == 0 && demangled != nullptr ? demangled : info.dli_sname;
+                    std::free(demangled);
+                    return name;
+                }
+                // Not a dynamic symbol (e.g. an executable built without
+                // -rdynamic): module + offset still locates it.
+                if (info.dli_fname != nullptr)
+                {
+                    const char* base = std::strrchr(info.dli_fname, '/');
+                    char offset[32]{};
+                    std::snprintf(offset, sizeof(offset), "+0x%zx",
+                        static_cast<std::size_t>(
+                            reinterpret_cast<std::uintptr_t>(target) -
+                            reinterpret_cast<std::uintptr_t>(info.dli_fbase)));
+                    return std::string(base != nullptr ? base + 1 : info.dli_fname) + offset;
+                }
+            }
+            char address[32]{};
+            std::snprintf(address, sizeof(address), "0x%zx",
+                static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(target)));
+            return address;
+        }
+
+        std::string RegionName(const Region& region)
+        {
+            return std::string("cppbm::") + (region.role != nullptr ? region.role : "code") + "::" + TargetName(region.target);
+        }
+
+        // jitdump format: tools/perf/Documentation/jitdump-specification.txt
+        constexpr std::uint32_t kJitMagic = 0x4A695444;
+        constexpr std::uint32_t kJitVersion = 1;
+        constexpr std::uint32_t kJitCodeLoad = 0;
+
+        struct JitHeader
+        {
+            std::uint32_t magic = kJitMagic;
+            std::uint32_t version = kJitVersion;
+            std::uint32_t total_size = sizeof(JitHeader);
+            std::uint32_t elf_mach = 0;
+            std::uint32_t pad1 = 0;
+            std::uint32_t pid = 0;
+            std::uint64_t timestamp = 0;
+            std::uint64_t flags = 0;
+        };
+
+        struct JitCodeLoad
+        {
+            std::uint32_t id = kJitCodeLoad;
+            std::uint32_t total_size = 0;
+            std::uint64_t timestamp = 0;
+            std::uint32_t pid = 0;
+            std::uint32_t tid = 0;
+            std::uint64_t vma = 0;
+            std::uint64_t code_addr = 0;
+            std::uint64_t code_size = 0;
+            std::uint64_t code_index = 0;
+        };
+
+        constexpr std::uint32_t ElfMachine()
+        {
+#if defined(__x86_64__)
+            return EM_X86_64;
+#elif defined(__i386__)
+            return EM_386;
+#elif defined(__aarch64__)
+            return EM_AARCH64;
+#elif defined(__arm__)
+            return EM_ARM;
+#else
+            return EM_NONE;
+#endif
+        }
+
+        // perf record -k mono: timestamps on CLOCK_MONOTONIC.
+        std::uint64_t Timestamp()
+        {
+            timespec ts{};
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<std::uint64_t>(ts.tv_nsec);
+        }
+
+        bool WriteAll(int fd, const void* data, std::size_t bytes)
+        {
+            const auto* p = static_cast<const char*>(data);
+            while (bytes > 0)
+            {
+                const ssize_t n = write(fd, p, bytes);
+                if (n <= 0)
+                {
+                    return false;
+                }
+                p += n;
+                bytes -= static_cast<std::size_t>(n);
+            }
+            return true;
+        }
+#endif
+
+        class PerfMap
+        {
+        public:
+            static PerfMap& GetInstance()
+            {
+                static PerfMap instance{};
+                return instance;
+            }
+
+            PerfMapMode Mode() const
+            {
+                return mode_.load(std::memory_order_acquire);
+            }
+
+            void SetMode(PerfMapMode mode)
+            {
+                std::lock_guard<std::mutex> guard{ mtx_ };
+                mode_.store(mode, std::memory_order_release);
+                FlushLocked();
+            }
+
+            void Register(const void* code, std::size_t size, const void* target, const char* role)
+            {
+                std::lock_guard<std::mutex> guard{ mtx_ };
+                regions_.push_back(Region{ reinterpret_cast<std::uintptr_t>(code), size, target, role });
+                FlushLocked();
+            }
+
+        private:
+            PerfMap()
+                : mode_(ModeFromEnvironment())
+            {
+            }
+
+            // Each output keeps its own prefix of regions_ already written, so
+            // switching modes back and forth never duplicates an entry.
+            void FlushLocked()
+            {
+#ifdef CPPBM_PERF_MAP_OUTPUT
+                const PerfMapMode mode = mode_.load(std::memory_order_relaxed);
+                if (mode == PerfMapMode::Off)
+                {
+                    return;
+                }
+                if (map_written_ < regions_.size() && OpenMapLocked())
+                {
+                    for (; map_written_ < regions_.size(); ++map_written_)
+                    {
+                        const Region& region = regions_[map_written_];
+                        std::fprintf(map_, "%zx %zx %s\n",
+                            static_cast<std::size_t>(region.code), region.size, RegionName(region).c_str());
+                    }
+                    std::fflush(map_);
+                }
+                if (mode == PerfMapMode::JitDump && dump_written_ < regions_.size() && OpenDumpLocked())
+                {
+                    for (; dump_written_ < regions_.size(); ++dump_written_)
+                    {
+                        WriteCodeLoadLocked(regions_[dump_written_]);
+                    }
+                }
+#endif
+            }
+
+#ifdef CPPBM_PERF_MAP_OUTPUT
+            bool OpenMapLocked()
+            {
+                if (map_ == nullptr)
+                {
+                    char path[64]{};
+                    std::snprintf(path, sizeof(path), "/tmp/perf-%d.map", static_cast<int>(getpid()));
+                    map_ = std::fopen(path, "a");
+                }
+                return map_ != nullptr;
+            }
+
+            bool OpenDumpLocked()
+            {
+                if (dump_fd_ >= 0)
+                {
+                    return true;
+                }
+                const char* dir = std::getenv("JITDUMP_DIR");
+                const std::string path = std::string(dir != nullptr && *dir != '\0' ? dir : "/tmp") +
+                    "/jit-" + std::to_string(getpid()) + ".dump";
+                const int fd = open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR | O_CLOEXEC, 0666);
+                if (fd < 0)
+                {
+                    return false;
+                }
+
+                JitHeader header{};
+                header.elf_mach = ElfMachine();
+                header.pid = static_cast<std::uint32_t>(getpid());
+                header.timestamp = Timestamp();
+                if (!WriteAll(fd, &header, sizeof(header)))
+                {
+                    close(fd);
+                    return false;
+                }
+
+                // perf record notices the dump through this executable mapping
+                // of it; it stays mapped for the life of the process.
+                const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+                void* marker = mmap(nullptr, page, PROT_READ | PROT_EXEC, MAP_PRIVATE, fd, 0);
+                if (marker == MAP_FAILED)
+                {
+                    close(fd);
+                    return false;
+                }
+                dump_fd_ = fd;
+                return true;
+            }
+
+            void WriteCodeLoadLocked(const Region& region)
+            {
+                const std::string name = RegionName(region);
+                JitCodeLoad record{};
+                record.total_size = static_cast<std::uint32_t>(sizeof(record) + name.size() + 1 + region.size);
+                record.timestamp = Timestamp();
+                record.pid = static_cast<std::uint32_t>(getpid());
+                record.tid = static_cast<std::uint32_t>(syscall(SYS_gettid));
+                record.vma = region.code;
+                record.code_addr = region.code;
+                record.code_size = region.size;
+                record.code_index = code_index_++;
+                (void)(WriteAll(dump_fd_, &record, sizeof(record)) &&
+                    WriteAll(dump_fd_, name.c_str(), name.size() + 1) &&
+                    WriteAll(dump_fd_, reinterpret_cast<const void*>(region.code), region.size));
+            }
+
+            std::FILE* map_ = nullptr;
+            int dump_fd_ = -1;
+            std::uint64_t code_index_ = 0;
+#endif
+
+            std::mutex mtx_{};
+            std::atomic<PerfMapMode> mode_{ PerfMapMode::Off };
+            std::vector<Region> regions_{};
+            std::size_t map_written_ = 0;
+            std::size_t dump_written_ = 0;
+        };
+    }
+
+    void SetPerfMapMode(PerfMapMode mode)
+    {
+        PerfMap::GetInstance().SetMode(mode);
+    }
+
+    PerfMapMode GetPerfMapMode()
+    {
+        return PerfMap::GetInstance().Mode();
+    }
+
+    void RegisterPerfRegion(const void* code, std::size_t size, const void* target, const char* role)
+    {
+        if (code == nullptr || size == 0)
+        {
+            return;
+        }
+        PerfMap::GetInstance().Register(code, size, target, role);
+    }
+}
@@ -0,0 +1,325 @@
+// Shared, non-template dispatch core for every HookPipeline instantiation.
+#include <algorithm>
+
+#include "cppbm/internal/hook/pipeline_core.h"
+
+namespace cpp::blackmagic::hook
+{
+    namespace
+    {
+        std::size_t AlignUp(std::size_t value, std::size_t align)
+        {
+            if (align <= 1)
+            {
+                return value;
+            }
+            const std::size_t rem = value % align;
+            return rem == 0 ? value : value + (align - rem);
+        }
+
+        std::atomic<HookInstallMode>& InstallModeStorage()
+        {
+#ifdef CPPBM_HOOK_LAZY_INSTALL
+            static std::atomic<HookInstallMode> mode{ HookInstallMode::Lazy };
+#else
+            static std::atomic<HookInstallMode> mode{ HookInstallMode::Eager };
+#endif
+            return mode;
+        }
+    }
+
+    void SetHookInstallMode(HookInstallMode mode)
+    {
+        InstallModeStorage().store(mode, std::memory_order_release);
+    }
+
+    HookInstallMode GetHookInstallMode()
+    {
+        return InstallModeStorage().load(std::memory_order_acquire);
+    }
+
+    HookPipelineCore::Frame::Frame(HookPipelineCore& core)
+        : read_guard_(core.epoch_)
+    {
+        ChainSnapshot* chain = core.snapshot_.load(std::memory_order_seq_cst);
+        if (chain == nullptr || chain->nodes.empty())
+        {
+            return;
+        }
+        std::call_once(chain->layout_once, [chain]() { BuildLayout(*chain); });
+        chain_ = chain;
+    }
+
+    std::size_t HookPipelineCore::Frame::StackBytes() const
+    {
+        const std::size_t bytes = chain_->arena_bytes;
+        if (bytes == 0 || bytes > CPPBM_HOOK_STACK_ARENA_LIMIT)
+        {
+            return 0;
+        }
+        return bytes + chain_->arena_align - 1;
+    }
+
+    void HookPipelineCore::Frame::BindArena(void* stack_memory)
+    {
+        if (stack_memory != nullptr)
+        {
+            arena_ = AlignPointer(stack_memory, chain_->arena_align);
+        }
+        else if (chain_->arena_bytes > 0)
+        {
+            arena_ = spill_.Allocate(chain_->arena_bytes, chain_->arena_align);
+        }
+    }
+
+    CallContext HookPipelineCore::Frame::ContextAt(std::size_t index) const
+    {
+        const ContextSlice& slice = chain_->slices[index];
+        void* slot_mem = (arena_ == nullptr || slice.size == 0)
+            ? nullptr
+            : static_cast<void*>(arena_ + slice.offset);
+        return CallContext(slot_mem, slice.size);
+    }
+
+    bool HookPipelineCore::Frame::RunBefore(BeforeThunk before, void* slots)
+    {
+        // Invoked-node bookkeeping is just a prefix length of the snapshot:
+        // the snapshot is immutable for the whole read section, so After...
+        // walks [0, invoked_) backwards and rebuilds each CallContext
+        // from the same slice. No per-call heap traffic.
+        DecoratorNodeBase* const* nodes = chain_->nodes.data();
+        const std::size_t count = chain_->nodes.size();
+        for (; invoked_ < count; ++invoked_)
+        {
+            CallContext ctx = ContextAt(invoked_);
+            if (!before(nodes[invoked_], ctx, slots))
+            {
+                // The rejecting node still receives its After... call.
+                ++invoked_;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void HookPipelineCore::Frame::RunAfter(AfterThunk after, void* result)
+    {
+        DecoratorNodeBase* const* nodes = chain_->nodes.data();
+        while (invoked_ > 0)
+        {
+            --invoked_;
+            CallContext ctx = ContextAt(invoked_);
+            after(nodes[invoked_], ctx, result);
+        }
+    }
+
+    HookPipelineCore::HookPipelineCore(void* target, void* detour, Hooker* hooker)
+        : HookState(hooker), target_(target), detour_(detour)
+    {
+    }
+
+    HookPipelineCore::~HookPipelineCore()
+    {
+        delete snapshot_.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    bool HookPipelineCore::RegisterNode(DecoratorNodeBase* node)
+    {
+        if (node == nullptr)
+        {
+            return false;
+        }
+
+        ChainSnapshot* retired = nullptr;
+        void* target = nullptr;
+        bool awaiting = false;
+        {
+            std::lock_guard<std::mutex> guard{ chain_mtx_ };
+            if (std::find(chain_.begin(), chain_.end(), node) == chain_.end())
+            {
+                // Virtual ContextSize() is queried later by BuildLayout().
+                // During base construction phase virtual dispatch is not stable.
+                chain_.push_back(node);
+                retired = PublishLocked();
+            }
+            target = target_;
+            awaiting = awaiting_target_;
+        }
+        // Publishing is enough: nothing waits for in-flight calls here, so a
+        // registration never blocks behind a long-running hooked call. The
+        // old snapshot is freed at once when no call is in flight, otherwise
+        // by a later registration or Unregister (or with the pipeline).
+        Defer(retired);
+
+        // Target not resolved yet: ResolveTarget() installs.
+        if (awaiting)
+        {
+            return true;
+        }
+
+        // Lazy: recorded only; Activate() patches the target.
+        if (!activated_.load(std::memory_order_acquire) && GetHookInstallMode() == HookInstallMode::Lazy)
+        {
+            return true;
+        }
+
+        if (HookState::InstallAt(target, detour_))
+        {
+            return true;
+        }
+
+        UnregisterNode(node);
+        return false;
+    }
+
+    bool HookPipelineCore::Activate()
+    {
+        activated_.store(true, std::memory_order_release);
+        void* target = nullptr;
+        {
+            std::lock_guard<std::mutex> guard{ chain_mtx_ };
+            if (chain_.empty() || awaiting_target_)
+            {
+                return true;
+            }
+            target = target_;
+        }
+        return HookState::InstallAt(target, detour_);
+    }
+
+    void HookPipelineCore::AwaitTarget()
+    {
+        std::lock_guard<std::mutex> guard{ chain_mtx_ };
+        if (target_ == nullptr)
+        {
+            awaiting_target_ = true;
+        }
+    }
+
+    bool HookPipelineCore::ResolveTarget(void* target)
+    {
+        {
+            std::lock_guard<std::mutex> guard{ chain_mtx_ };
+            if (!awaiting_target_)
+            {
+                return target_ == target;
+            }
+            target_ = target;
+            awaiting_target_ = false;
+            if (chain_.empty())
+            {
+                return true;
+            }
+        }
+
+        if (!activated_.load(std::memory_order_acquire) && GetHookInstallMode() == HookInstallMode::Lazy)
+        {
+            return true;
+        }
+        return HookState::InstallAt(target, detour_);
+    }
+
+    HookPipelineState HookPipelineCore::State() const
+    {
+        if (IsBypassed())
+        {
+            return HookPipelineState::Bypassed;
+        }
+        if (HookState::IsInstalled())
+        {
+            return HookPipelineState::Installed;
+        }
+        std::lock_guard<std::mutex> guard{ chain_mtx_ };
+        return chain_.empty() ? HookPipelineState::Idle : HookPipelineState::Registered;
+    }
+
+    void HookPipelineCore::UnregisterNode(DecoratorNodeBase* node)
+    {
+        if (node == nullptr)
+        {
+            return;
+        }
+
+        ChainSnapshot* retired = nullptr;
+        {
+            std::lock_guard<std::mutex> guard{ chain_mtx_ };
+            const auto found = std::find(chain_.begin(), chain_.end(), node);
+            if (found == chain_.end())
+            {
+                return;
+            }
+            chain_.erase(found);
+            retired = PublishLocked();
+        }
+        // Waits for in-flight dispatches, so the caller may destroy node afterwards.
+        // (Unregistering from inside a call to this same target cannot wait.)
+        Reclaim(retired);
+    }
+
+    bool HookPipelineCore::SetBypass(bool bypass)
+    {
+        if (bypass)
+        {
+            // Flag first: callers that still reach the detour while the
+            // prologue is being restored already skip the chain.
+            bypass_.store(true, std::memory_order_release);
+            return HookState::SetEnabled(false);
+        }
+
+        if (!HookState::SetEnabled(true))
+        {
+            return false;
+        }
+        bypass_.store(false, std::memory_order_release);
+        return true;
+    }
+
+    void HookPipelineCore::BuildLayout(ChainSnapshot& chain)
+    {
+        std::size_t offset = 0;
+        std::size_t max_align = 1;
+        for (std::size_t i = 0; i < chain.nodes.size(); ++i)
+        {
+            ContextSlice& slice = chain.slices[i];
+            slice.size = chain.nodes[i]->ContextSize();
+            if (slice.size == 0)
+            {
+                slice.offset = 0;
+                continue;
+            }
+            const std::size_t align = NormalizeContextAlign(chain.nodes[i]->ContextAlign());
+            slice.offset = AlignUp(offset, align);
+            offset = slice.offset + slice.size;
+            max_align = std::max(max_align, align);
+        }
+        chain.arena_bytes = offset;
+        chain.arena_align = max_align;
+    }
+
+    HookPipelineCore::ChainSnapshot* HookPipelineCore::PublishLocked()
+    {
+        auto* next = new ChainSnapshot{};
+        next->nodes = chain_;
+        next->slices.resize(chain_.size());
+        return snapshot_.exchange(next, std::memory_order_seq_cst);
+    }
+
+    void HookPipelineCore::Reclaim(ChainSnapshot* retired)
+    {
+        if (retired == nullptr)
+        {
+            return;
+        }
+        epoch_.Retire(retired, &DeleteSnapshot);
+    }
+
+    void HookPipelineCore::Defer(ChainSnapshot* retired)
+    {
+        epoch_.Defer(retired, &DeleteSnapshot);
+    }
+
+    void HookPipelineCore::DeleteSnapshot(void* snapshot)
+    {
+        delete static_cast<ChainSnapshot*>(snapshot);
+    }
+}
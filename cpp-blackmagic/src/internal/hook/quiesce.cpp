@@ -0,0 +1,456 @@
+// Stop-the-world code writes for live patching (see quiesce.h).
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <ucontext.h>
+#include <unistd.h>
+#define CPPBM_HOOK_QUIESCE_SIGNALS 1
+#endif
+
+#include "cppbm/internal/hook/quiesce.h"
+
+#ifndef CPPBM_HOOK_STOP_SIGNAL
+#define CPPBM_HOOK_STOP_SIGNAL (SIGRTMIN + 5)
+#endif
+
+#ifndef CPPBM_HOOK_STOP_TIMEOUT_MS
+#define CPPBM_HOOK_STOP_TIMEOUT_MS 100
+#endif
+
+#ifndef CPPBM_HOOK_STOP_ATTEMPTS
+#define CPPBM_HOOK_STOP_ATTEMPTS 16
+#endif
+
+namespace cpp::blackmagic::hook
+{
+    namespace
+    {
+        std::atomic<LivePatchMode>& LivePatchModeStorage()
+        {
+#ifdef CPPBM_HOOK_STOP_THE_WORLD
+            static std::atomic<LivePatchMode> mode{ LivePatchMode::StopTheWorld };
+#else
+            static std::atomic<LivePatchMode> mode{ LivePatchMode::Direct };
+#endif
+            return mode;
+        }
+
+        std::mutex& SessionMutex()
+        {
+            static std::mutex mtx{};
+            return mtx;
+        }
+
+        std::mutex& StatsMutex()
+        {
+            static std::mutex mtx{};
+            return mtx;
+        }
+
+        LivePatchStats& StatsStorage()
+        {
+            static LivePatchStats stats{};
+            return stats;
+        }
+
+#ifdef CPPBM_HOOK_QUIESCE_SIGNALS
+        using Clock = std::chrono::steady_clock;
+
+        // One thread of the current session. Written by the installer before
+        // the thread is signaled; `pc` and `parked` by the thread's handler.
+        struct ParkedThread
+        {
+            std::atomic<pid_t> tid{ 0 };
+            std::atomic<std::uintptr_t> pc{ 0 };
+            // Session the thread parked for: a handler left over from an
+            // earlier session never counts for the current one.
+            std::atomic<std::uint32_t> parked{ 0 };
+        };
+
+        // Shared with the signal handler: plain atomics only.
+        std::atomic<ParkedThread*> g_threads{ nullptr };
+        std::atomic<std::size_t> g_thread_count{ 0 };
+        std::atomic<std::uint32_t> g_session{ 0 };
+        // futex word: id of the last released session.
+        int g_released = 0;
+
+        // Table owned by the installer, under SessionMutex().
+        std::unique_ptr<ParkedThread[]> g_table{};
+        std::size_t g_capacity = 0;
+        std::uint32_t g_next_session = 0;
+
+        pid_t CurrentTid()
+        {
+            return static_cast<pid_t>(syscall(SYS_gettid));
+        }
+
+        std::uintptr_t InterruptedPc(void* context)
+        {
+            const auto* uc = static_cast<const ucontext_t*>(context);
+#if defined(__x86_64__)
+            return static_cast<std::uintptr_t>(uc->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__i386__)
+            return static_cast<std::uintptr_t>(uc->uc_mcontext.gregs[REG_EIP]);
+#elif defined(__aarch64__)
+            return static_cast<std::uintptr_t>(uc->uc_mcontext.pc);
+#elif defined(__arm__)
+            return static_cast<std::uintptr_t>(uc->uc_mcontext.arm_pc);
+#else
+            (void)uc;
+            return 0;
+#endif
+        }
+
+        void OnStopSignal(int, siginfo_t*, void* context)
+        {
+            const int saved_errno = errno;
+            const std::uint32_t session = g_session.load(std::memory_order_acquire);
+            if (session != 0)
+            {
+                const pid_t self = CurrentTid();
+                ParkedThread* threads = g_threads.load(std::memory_order_acquire);
+                const std::size_t count = g_thread_count.load(std::memory_order_acquire);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    if (threads[i].tid.load(std::memory_order_relaxed) != self)
+                    {
+                        continue;
+                    }
+                    threads[i].pc.store(InterruptedPc(context), std::memory_order_relaxed);
+                    threads[i].parked.store(session, std::memory_order_release);
+                    int released = __atomic_load_n(&g_released, __ATOMIC_ACQUIRE);
+                    while (static_cast<std::uint32_t>(released) != session)
+                    {
+                        syscall(SYS_futex, &g_released, FUTEX_WAIT_PRIVATE, released, nullptr, nullptr, 0);
+                        released = __atomic_load_n(&g_released, __ATOMIC_ACQUIRE);
+                    }
+                    break;
+                }
+            }
+            errno = saved_errno;
+        }
+
+        bool InstallHandler()
+        {
+            static const bool installed = []()
+                {
+                    struct sigaction action{};
+                    action.sa_sigaction = &OnStopSignal;
+                    action.sa_flags = SA_SIGINFO | SA_RESTART;
+                    sigemptyset(&action.sa_mask);
+                    return sigaction(CPPBM_HOOK_STOP_SIGNAL, &action, nullptr) == 0;
+                }();
+            return installed;
+        }
+
+        // Calls fn(tid) for every thread of the process. Raw getdents64 on a
+        // stack buffer: no allocation, so it can run with the world stopped.
+        template <typename Fn>
+        bool ForEachThread(Fn&& fn)
+        {
+            struct Dirent64
+            {
+                std::uint64_t ino;
+                std::int64_t off;
+                unsigned short reclen;
+                unsigned char type;
+                char name[1];
+            };
+
+            const int fd = open("/proc/self/task", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                return false;
+            }
+            alignas(8) char buffer[4096];
+            bool ok = true;
+            for (;;)
+            {
+                const long bytes = syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+                if (bytes <= 0)
+                {
+                    ok = bytes == 0;
+                    break;
+                }
+                for (long offset = 0; offset < bytes;)
+                {
+                    const auto* entry = reinterpret_cast<const Dirent64*>(buffer + offset);
+                    offset += entry->reclen;
+                    pid_t tid = 0;
+                    const char* c = entry->name;
+                    for (; *c >= '0' && *c <= '9'; ++c)
+                    {
+                        tid = tid * 10 + (*c - '0');
+                    }
+                    if (*c == '\0' && tid > 0 && !fn(tid))
+                    {
+                        close(fd);
+                        return false;
+                    }
+                }
+            }
+            close(fd);
+            return ok;
+        }
+
+        void Release(std::uint32_t session)
+        {
+            g_session.store(0, std::memory_order_seq_cst);
+            __atomic_store_n(&g_released, static_cast<int>(session), __ATOMIC_RELEASE);
+            syscall(SYS_futex, &g_released, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+        }
+
+        enum class ParkResult
+        {
+            Parked,
+            Failed,
+        };
+
+        // Signal every other thread, including ones created meanwhile, until a
+        // full listing finds nobody new and every live thread has parked.
+        ParkResult Park(std::uint32_t session, pid_t self, std::size_t& parked)
+        {
+            const pid_t pid = getpid();
+            ParkedThread* table = g_table.get();
+            std::size_t count = 0;
+            g_threads.store(table, std::memory_order_release);
+            g_thread_count.store(0, std::memory_order_release);
+            g_session.store(session, std::memory_order_seq_cst);
+
+            const auto deadline = Clock::now() + std::chrono::milliseconds(CPPBM_HOOK_STOP_TIMEOUT_MS);
+            for (;;)
+            {
+                bool added = false;
+                const bool listed = ForEachThread([&](pid_t tid)
+                    {
+                        if (tid == self)
+                        {
+                            return true;
+                        }
+                        for (std::size_t i = 0; i < count; ++i)
+                        {
+                            if (table[i].tid.load(std::memory_order_relaxed) == tid)
+                            {
+                                return true;
+                            }
+                        }
+                        if (count == g_capacity)
+                        {
+                            return false;
+                        }
+                        ParkedThread& slot = table[count++];
+                        slot.tid.store(tid, std::memory_order_relaxed);
+                        slot.pc.store(0, std::memory_order_relaxed);
+                        slot.parked.store(0, std::memory_order_relaxed);
+                        g_thread_count.store(count, std::memory_order_release);
+                        if (syscall(SYS_tgkill, pid, tid, CPPBM_HOOK_STOP_SIGNAL) != 0)
+                        {
+                            // Exited since the listing.
+                            slot.tid.store(-1, std::memory_order_relaxed);
+                        }
+                        added = true;
+                        return true;
+                    });
+                if (!listed)
+                {
+                    return ParkResult::Failed;
+                }
+
+                for (;;)
+                {
+                    parked = 0;
+                    std::size_t waiting = 0;
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        const pid_t tid = table[i].tid.load(std::memory_order_relaxed);
+                        if (tid <= 0)
+                        {
+                            continue;
+                        }
+                        if (table[i].parked.load(std::memory_order_acquire) == session)
+                        {
+                            ++parked;
+                        }
+                        else if (syscall(SYS_tgkill, pid, tid, 0) != 0 && errno == ESRCH)
+                        {
+                            table[i].tid.store(-1, std::memory_order_relaxed);
+                        }
+                        else
+                        {
+                            ++waiting;
+                        }
+                    }
+                    if (waiting == 0)
+                    {
+                        break;
+                    }
+                    if (Clock::now() > deadline)
+                    {
+                        return ParkResult::Failed;
+                    }
+                    const timespec nap{ 0, 20000 };
+                    nanosleep(&nap, nullptr);
+                }
+
+                if (!added)
+                {
+                    return ParkResult::Parked;
+                }
+            }
+        }
+
+        bool AnyInside(const PatchRange* ranges, std::size_t count)
+        {
+            const ParkedThread* table = g_table.get();
+            const std::size_t threads = g_thread_count.load(std::memory_order_relaxed);
+            for (std::size_t t = 0; t < threads; ++t)
+            {
+                if (table[t].tid.load(std::memory_order_relaxed) <= 0)
+                {
+                    continue;
+                }
+                const std::uintptr_t pc = table[t].pc.load(std::memory_order_relaxed);
+                for (std::size_t r = 0; r < count; ++r)
+                {
+                    // At the first byte is fine: the thread fetches the new
+                    // instruction there once resumed.
+                    const auto begin = reinterpret_cast<std::uintptr_t>(ranges[r].begin);
+                    if (pc > begin && pc < begin + ranges[r].bytes)
+                    {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        void RecordPause(Clock::time_point start, std::size_t threads)
+        {
+            const auto ns = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+            std::lock_guard<std::mutex> guard{ StatsMutex() };
+            LivePatchStats& stats = StatsStorage();
+            ++stats.pauses;
+            stats.last_pause_ns = ns;
+            stats.total_pause_ns += ns;
+            stats.max_pause_ns = ns > stats.max_pause_ns ? ns : stats.max_pause_ns;
+            stats.last_threads = threads;
+        }
+
+        void RecordOutcome(bool retry)
+        {
+            std::lock_guard<std::mutex> guard{ StatsMutex() };
+            ++(retry ? StatsStorage().retries : StatsStorage().failures);
+        }
+
+        // Session state between the constructor and the destructor.
+        std::uint32_t g_active_session = 0;
+        Clock::time_point g_active_start{};
+        std::size_t g_active_threads = 0;
+#endif
+    }
+
+    void SetLivePatchMode(LivePatchMode mode)
+    {
+        LivePatchModeStorage().store(mode, std::memory_order_release);
+    }
+
+    LivePatchMode GetLivePatchMode()
+    {
+        return LivePatchModeStorage().load(std::memory_order_acquire);
+    }
+
+    LivePatchStats GetLivePatchStats()
+    {
+        std::lock_guard<std::mutex> guard{ StatsMutex() };
+        return StatsStorage();
+    }
+
+    PatchQuiescence::PatchQuiescence(const PatchRange* ranges, std::size_t count)
+    {
+#ifdef CPPBM_HOOK_QUIESCE_SIGNALS
+        if (count == 0 || GetLivePatchMode() != LivePatchMode::StopTheWorld)
+        {
+            return;
+        }
+
+        // One session at a time, process-wide.
+        session_ = std::unique_lock<std::mutex>{ SessionMutex() };
+        safe_ = false;
+        if (!InstallHandler())
+        {
+            RecordOutcome(false);
+            return;
+        }
+
+        // Size the table before anything is stopped: room for threads
+        // started while parking.
+        std::size_t threads = 0;
+        (void)ForEachThread([&threads](pid_t) { ++threads; return true; });
+        if (g_capacity < threads * 2 + 64)
+        {
+            // The old table is leaked on purpose: a handler signaled in an
+            // earlier session may still be scanning it.
+            (void)g_table.release();
+            g_capacity = threads * 2 + 64;
+            g_table.reset(new ParkedThread[g_capacity]);
+        }
+
+        const pid_t self = CurrentTid();
+        for (int attempt = 0; attempt < CPPBM_HOOK_STOP_ATTEMPTS; ++attempt)
+        {
+            g_next_session = g_next_session + 1 == 0 ? 1 : g_next_session + 1;
+            const std::uint32_t session = g_next_session;
+            const Clock::time_point start = Clock::now();
+            std::size_t parked = 0;
+            if (Park(session, self, parked) != ParkResult::Parked)
+            {
+                Release(session);
+                RecordPause(start, parked);
+                RecordOutcome(false);
+                return;
+            }
+            if (!AnyInside(ranges, count))
+            {
+                g_active_session = session;
+                g_active_start = start;
+                g_active_threads = parked;
+                stopped_ = true;
+                safe_ = true;
+                return;
+            }
+
+            Release(session);
+            RecordPause(start, parked);
+            RecordOutcome(true);
+            // Let the thread run past the patched bytes.
+            const timespec nap{ 0, 200000 };
+            nanosleep(&nap, nullptr);
+        }
+        RecordOutcome(false);
+#else
+        (void)ranges;
+        (void)count;
+#endif
+    }
+
+    PatchQuiescence::~PatchQuiescence()
+    {
+#ifdef CPPBM_HOOK_QUIESCE_SIGNALS
+        if (stopped_)
+        {
+            Release(g_active_session);
+            RecordPause(g_active_start, g_active_threads);
+        }
+#endif
+    }
+}
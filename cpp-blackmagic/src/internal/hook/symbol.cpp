@@ -0,0 +1,246 @@
+// Runtime (library, symbol) decorator targets.
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#if defined(__APPLE__)
+#include <mach-o/dyld.h>
+#endif
+
+#include "cppbm/internal/hook/error.h"
+#include "cppbm/internal/hook/symbol.h"
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include "internal/hooker/plt.h"
+#endif
+
+namespace cpp::blackmagic::hook
+{
+    namespace
+    {
+        // Address of `symbol` if `library` is loaded; the library is pinned
+        // on success. Never loads anything itself.
+        void* LookUp(const std::string& library, const std::string& symbol)
+        {
+#if defined(_WIN32)
+            HMODULE module = nullptr;
+            if (library.empty())
+            {
+                module = GetModuleHandleA(nullptr);
+            }
+            else if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_PIN, library.c_str(), &module))
+            {
+                return nullptr;
+            }
+            return module != nullptr
+                ? reinterpret_cast<void*>(GetProcAddress(module, symbol.c_str()))
+                : nullptr;
+#else
+            if (library.empty())
+            {
+                return dlsym(RTLD_DEFAULT, symbol.c_str());
+            }
+            void* handle = dlopen(library.c_str(), RTLD_NOW | RTLD_NOLOAD);
+            if (handle == nullptr)
+            {
+                return nullptr;
+            }
+            void* address = dlsym(handle, symbol.c_str());
+            if (address == nullptr)
+            {
+                dlclose(handle);
+            }
+            // Otherwise the reference taken by dlopen() is kept on purpose.
+            return address;
+#endif
+        }
+
+#if !defined(_WIN32)
+        // Rescan() itself calls dlopen(); nested scans on this thread are
+        // skipped instead of re-entering the table.
+        thread_local bool t_in_rescan = false;
+#endif
+
+#if defined(__linux__) || defined(__ANDROID__)
+        void OnLibraryLoaded()
+        {
+            (void)SymbolTargets::GetInstance().Rescan();
+        }
+
+        // Loads are watched by rewriting the GOT slots that import dlopen(),
+        // not by inline-patching libc: dlopen's own prologue is not a
+        // target every inline backend relocates safely. With the plt backend
+        // the process-wide hooker already owns that interception.
+        PltHooker& LoadWatcher()
+        {
+#ifdef CPPBM_HOOK_PLT_BACKEND
+            return static_cast<PltHooker&>(Hooker::GetInstance());
+#else
+            static PltHooker watcher{};
+            return watcher;
+#endif
+        }
+#elif defined(__APPLE__)
+        void OnImageAdded(const struct mach_header*, intptr_t)
+        {
+            (void)SymbolTargets::GetInstance().Rescan();
+        }
+#endif
+    }
+
+    SymbolTargets& SymbolTargets::GetInstance()
+    {
+        static SymbolTargets instance{};
+        return instance;
+    }
+
+    void* SymbolTargets::Acquire(
+        const char* library,
+        const char* symbol,
+        const void* signature,
+        std::size_t slots,
+        CreateFn create,
+        ResolveFn resolve)
+    {
+        const std::string library_name = library != nullptr ? library : "";
+        const std::string symbol_name = symbol != nullptr ? symbol : "";
+
+        Entry* entry = nullptr;
+        {
+            std::lock_guard<std::mutex> guard{ mtx_ };
+            std::size_t used = 0;
+            for (const auto& existing : entries_)
+            {
+                if (existing->signature != signature)
+                {
+                    continue;
+                }
+                if (existing->library == library_name && existing->symbol == symbol_name)
+                {
+                    return existing->pipeline;
+                }
+                ++used;
+            }
+
+            if (used >= slots)
+            {
+                HandleHookFailure(HookError{
+                    HookErrorCode::DetourPoolExhausted,
+                    nullptr,
+                    nullptr,
+                    "Symbol target failed: detour pool of this signature is exhausted (CPPBM_HOOK_SYMBOL_SLOTS)."
+                    });
+                return nullptr;
+            }
+
+            auto created = std::make_unique<Entry>();
+            created->library = library_name;
+            created->symbol = symbol_name;
+            created->signature = signature;
+            created->pipeline = create(used);
+            created->resolve = resolve;
+            entry = created.get();
+            entries_.push_back(std::move(created));
+        }
+
+        void* address = LookUp(entry->library, entry->symbol);
+        if (address == nullptr)
+        {
+            // Watch first, then look again: a load in between is not missed.
+            WatchLoads();
+            address = LookUp(entry->library, entry->symbol);
+            if (address == nullptr)
+            {
+                return entry->pipeline;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> guard{ mtx_ };
+            if (entry->resolved)
+            {
+                return entry->pipeline;
+            }
+            entry->resolved = true;
+        }
+        (void)entry->resolve(entry->pipeline, address);
+        return entry->pipeline;
+    }
+
+    std::size_t SymbolTargets::Rescan()
+    {
+#if !defined(_WIN32)
+        if (t_in_rescan)
+        {
+            return 0;
+        }
+        t_in_rescan = true;
+#endif
+
+        std::vector<Entry*> pending{};
+        {
+            std::lock_guard<std::mutex> guard{ mtx_ };
+            for (const auto& entry : entries_)
+            {
+                if (!entry->resolved)
+                {
+                    pending.push_back(entry.get());
+                }
+            }
+        }
+
+        // Installs run unlocked: a backend may take its own locks.
+        std::size_t resolved = 0;
+        for (Entry* entry : pending)
+        {
+            void* address = LookUp(entry->library, entry->symbol);
+            if (address == nullptr)
+            {
+                continue;
+            }
+            {
+                std::lock_guard<std::mutex> guard{ mtx_ };
+                if (entry->resolved)
+                {
+                    continue;
+                }
+                entry->resolved = true;
+            }
+            (void)entry->resolve(entry->pipeline, address);
+            ++resolved;
+        }
+
+#if !defined(_WIN32)
+        t_in_rescan = false;
+#endif
+        return resolved;
+    }
+
+    std::size_t SymbolTargets::Pending() const
+    {
+        std::lock_guard<std::mutex> guard{ mtx_ };
+        std::size_t count = 0;
+        for (const auto& entry : entries_)
+        {
+            count += entry->resolved ? 0 : 1;
+        }
+        return count;
+    }
+
+    void SymbolTargets::WatchLoads()
+    {
+        std::call_once(watch_once_, []()
+            {
+#if defined(__linux__) || defined(__ANDROID__)
+                (void)LoadWatcher().WatchLoads(&OnLibraryLoaded);
+#elif defined(__APPLE__)
+                // Also reports every image loaded so far, i.e. rescans once now.
+                _dyld_register_func_for_add_image(&OnImageAdded);
+#endif
+            });
+    }
+}
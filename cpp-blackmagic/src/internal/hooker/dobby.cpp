@@ -1,33 +1,261 @@
 // dobby hooker, for linux x86/x86_64/arm/arm64, andorid x86/x86_64/arm/arm64
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
 #include <Dobby/Dobby.h>
 
 #include "cppbm/internal/hook/hooker.h"
+#include "cppbm/internal/hook/perf_map.h"
+#include "cppbm/internal/hook/quiesce.h"
 
 class DobbyHooker : public cpp::blackmagic::hook::Hooker
 {
 public:
 	bool CreateHook(void* target, void* detour, void** origin) override
 	{
-		return DobbyHook(target, detour, origin) == 0;
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		Patch patch{};
+		std::memcpy(patch.original, target, kProbeBytes);
+		if (DobbyHook(target, detour, origin) != 0)
+		{
+			return false;
+		}
+		std::memcpy(patch.patched, target, kProbeBytes);
+		RegisterTrampoline(target, *origin);
+
+		// Patch length = extent of bytes Dobby rewrote in the prologue.
+		for (std::size_t i = kProbeBytes; i > 0; --i)
+		{
+			if (patch.original[i - 1] != patch.patched[i - 1])
+			{
+				patch.length = i;
+				break;
+			}
+		}
+		patches_[target] = patch;
+		return true;
 	}
 
-	// Dobby backend doesn't have enable hook design
+	// Dobby backend doesn't have enable/disable hook design:
+	// emulate it by re-writing the patched / original prologue bytes captured
+	// in CreateHook. Dobby's trampoline stays alive in both states.
 	bool EnableHook(void* target) override
 	{
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		auto it = patches_.find(target);
+		if (it == patches_.end())
+		{
+			return false;
+		}
+		if (it->second.enabled)
+		{
+			return true;
+		}
+		if (!WriteCode(target, it->second.patched, it->second.length))
+		{
+			return false;
+		}
+		it->second.enabled = true;
 		return true;
 	}
 
-	// Dobby backend doesn't have disable hook design
 	bool DisableHook(void* target) override
 	{
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		auto it = patches_.find(target);
+		if (it == patches_.end())
+		{
+			return false;
+		}
+		if (!it->second.enabled)
+		{
+			return true;
+		}
+		if (!WriteCode(target, it->second.original, it->second.length))
+		{
+			return false;
+		}
+		it->second.enabled = false;
 		return true;
 	}
 
 	bool RemoveHook(void* target) override
 	{
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		auto it = patches_.find(target);
+		if (it != patches_.end())
+		{
+			// Hand Dobby back the state it created, so its own restore is exact.
+			if (!it->second.enabled)
+			{
+				(void)WriteCode(target, it->second.patched, it->second.length);
+			}
+			patches_.erase(it);
+			queued_.erase(std::remove(queued_.begin(), queued_.end(), target), queued_.end());
+		}
 		return DobbyDestroy(target) == 0;
 	}
+
+	// DobbyHook() patches inside CreateHook, so a fresh hook is already live
+	// and queueing it is a no-op; the queue batches re-enables of disabled
+	// hooks (e.g. bypass toggles) into one write per page run.
+	bool QueueEnableHook(void* target) override
+	{
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		auto it = patches_.find(target);
+		if (it == patches_.end())
+		{
+			return false;
+		}
+		if (!it->second.enabled)
+		{
+			queued_.push_back(target);
+		}
+		return true;
+	}
+
+	bool ApplyQueued() override
+	{
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		std::vector<Write> writes{};
+		for (void* target : queued_)
+		{
+			auto it = patches_.find(target);
+			if (it != patches_.end() && !it->second.enabled)
+			{
+				writes.push_back(Write{ static_cast<unsigned char*>(target), it->second.patched, it->second.length });
+			}
+		}
+		queued_.clear();
+		if (!WriteCode(writes))
+		{
+			return false;
+		}
+		for (const Write& write : writes)
+		{
+			patches_[write.target].enabled = true;
+		}
+		return true;
+	}
+
+private:
+	// Upper bound of any Dobby inline patch (arm64 absolute branch is 16 bytes).
+	static constexpr std::size_t kProbeBytes = 32;
+
+	// Dobby does not report trampoline sizes: relocated patch + jump back
+	// fits this on every architecture, clamped so it never runs past the
+	// trampoline's page.
+	static constexpr std::size_t kTrampolineBytes = 48;
+
+	static void RegisterTrampoline(void* target, void* trampoline)
+	{
+		const auto page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+		const auto addr = reinterpret_cast<std::uintptr_t>(trampoline);
+		const std::uintptr_t page_end = (addr | (page - 1)) + 1;
+		cpp::blackmagic::hook::RegisterPerfRegion(
+			trampoline, std::min<std::size_t>(kTrampolineBytes, page_end - addr), target, "trampoline");
+	}
+
+	struct Patch
+	{
+		unsigned char original[kProbeBytes]{};
+		unsigned char patched[kProbeBytes]{};
+		std::size_t length = 0;
+		bool enabled = true;
+	};
+
+	struct Write
+	{
+		unsigned char* target = nullptr;
+		const unsigned char* bytes = nullptr;
+		std::size_t length = 0;
+	};
+
+	static bool WriteCode(void* target, const unsigned char* bytes, std::size_t length)
+	{
+		return WriteCode({ Write{ static_cast<unsigned char*>(target), bytes, length } });
+	}
+
+	// Not atomic with respect to threads executing the prologue right now;
+	// callers switch hooks while the target is quiescent, or run in
+	// StopTheWorld mode (see quiesce.h).
+	// Writes are sorted and merged into page runs: one RWX/RX mprotect pair
+	// per run. Either every run is unlocked and written, or nothing is.
+	static bool WriteCode(std::vector<Write> writes)
+	{
+		const auto page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+		std::sort(writes.begin(), writes.end(),
+			[](const Write& a, const Write& b) { return a.target < b.target; });
+
+		std::vector<std::pair<std::uintptr_t, std::uintptr_t>> runs{};
+		std::vector<cpp::blackmagic::hook::PatchRange> ranges{};
+		for (const Write& write : writes)
+		{
+			if (write.length == 0)
+			{
+				continue;
+			}
+			ranges.push_back(cpp::blackmagic::hook::PatchRange{ write.target, write.length });
+			const auto addr = reinterpret_cast<std::uintptr_t>(write.target);
+			const std::uintptr_t begin = addr & ~(page - 1);
+			const std::uintptr_t end = (addr + write.length + page - 1) & ~(page - 1);
+			if (!runs.empty() && begin <= runs.back().second)
+			{
+				runs.back().second = std::max(runs.back().second, end);
+			}
+			else
+			{
+				runs.emplace_back(begin, end);
+			}
+		}
+
+		// Everything above allocates; nothing below may while threads are parked.
+		const cpp::blackmagic::hook::PatchQuiescence quiescence{ ranges.data(), ranges.size() };
+		if (!quiescence.Safe())
+		{
+			return false;
+		}
+
+		std::size_t unlocked = 0;
+		for (; unlocked < runs.size(); ++unlocked)
+		{
+			const auto& run = runs[unlocked];
+			if (mprotect(reinterpret_cast<void*>(run.first), run.second - run.first,
+				PROT_READ | PROT_WRITE | PROT_EXEC) != 0)
+			{
+				break;
+			}
+		}
+
+		const bool ok = unlocked == runs.size();
+		if (ok)
+		{
+			for (const Write& write : writes)
+			{
+				std::memcpy(write.target, write.bytes, write.length);
+				char* code = reinterpret_cast<char*>(write.target);
+				__builtin___clear_cache(code, code + write.length);
+			}
+		}
+
+		for (std::size_t i = 0; i < unlocked; ++i)
+		{
+			const auto& run = runs[i];
+			(void)mprotect(reinterpret_cast<void*>(run.first), run.second - run.first, PROT_READ | PROT_EXEC);
+		}
+		return ok;
+	}
+
+	std::mutex mtx_{};
+	std::unordered_map<void*, Patch> patches_{};
+	std::vector<void*> queued_{};
 };
 
 cpp::blackmagic::hook::Hooker& cpp::blackmagic::hook::Hooker::GetInstance()
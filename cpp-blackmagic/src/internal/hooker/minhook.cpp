@@ -38,6 +38,17 @@ public:
 		return init_ok_ && (MH_RemoveHook(target) == MH_OK);
 	}
 
+	bool QueueEnableHook(void* target) override
+	{
+		return init_ok_ && (MH_QueueEnableHook(target) == MH_OK);
+	}
+
+	// MinHook suspends the other threads once and patches all queued targets.
+	bool ApplyQueued() override
+	{
+		return init_ok_ && (MH_ApplyQueued() == MH_OK);
+	}
+
 private:
 	bool init_ok_ = false;
 };
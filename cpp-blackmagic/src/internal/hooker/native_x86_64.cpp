@@ -0,0 +1,936 @@
+// native hooker, for linux/android x86_64 (see native_x86_64.h)
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "native_x86_64.h"
+#include "cppbm/internal/hook/perf_map.h"
+#include "cppbm/internal/hook/quiesce.h"
+
+namespace cpp::blackmagic::hook
+{
+	namespace
+	{
+		// ---------------------------------------------------------------
+		// Length disassembler (64-bit mode).
+		//
+		// Only what prologue relocation needs: instruction length, where a
+		// RIP-relative disp32 sits, and whether the instruction is a relative
+		// branch / call / return. Covers legacy, REX, 0F / 0F38 / 0F3A, VEX
+		// and EVEX encodings.
+		// ---------------------------------------------------------------
+		enum class InsnKind
+		{
+			Invalid,
+			Plain,
+			Return,
+			JmpIndirect,
+			JmpRel,
+			CallRel,
+			JccRel,
+			LoopRel,
+		};
+
+		struct Insn
+		{
+			InsnKind kind = InsnKind::Invalid;
+			std::size_t length = 0;
+			std::size_t rip_disp_offset = 0; // 0 = no RIP-relative operand
+			std::size_t rel_offset = 0;
+			std::size_t rel_size = 0;
+			unsigned char cond = 0;          // JccRel condition code (low nibble)
+			bool padding = false;            // nop / int3 filler
+		};
+
+		constexpr std::size_t kMaxInsnBytes = 15;
+
+		// ModRM (+SIB +disp). Returns false on truncated encodings.
+		bool DecodeModRM(const unsigned char* code, std::size_t& pos, Insn& insn, unsigned& reg)
+		{
+			const unsigned char modrm = code[pos++];
+			const unsigned mod = modrm >> 6;
+			const unsigned rm = modrm & 7u;
+			reg = (modrm >> 3) & 7u;
+			if (mod == 3)
+			{
+				return true;
+			}
+
+			std::size_t disp = 0;
+			if (rm == 4)
+			{
+				const unsigned char sib = code[pos++];
+				if (mod == 0 && (sib & 7u) == 5)
+				{
+					disp = 4;
+				}
+			}
+			if (mod == 0 && rm == 5)
+			{
+				insn.rip_disp_offset = pos;
+				disp = 4;
+			}
+			else if (mod == 1)
+			{
+				disp = 1;
+			}
+			else if (mod == 2)
+			{
+				disp = 4;
+			}
+			pos += disp;
+			return pos <= kMaxInsnBytes;
+		}
+
+		// Opcodes of the 0F map (legacy and VEX/EVEX map 1) that carry imm8.
+		bool Map1HasImm8(unsigned char op)
+		{
+			return (op >= 0x70 && op <= 0x73) || op == 0xA4 || op == 0xAC || op == 0xBA ||
+				op == 0xC2 || op == 0xC4 || op == 0xC5 || op == 0xC6 || op == 0x0F;
+		}
+
+		bool Map1HasNoModRM(unsigned char op)
+		{
+			return op == 0x05 || op == 0x06 || op == 0x07 || op == 0x08 || op == 0x09 || op == 0x0B ||
+				op == 0x0E || (op >= 0x30 && op <= 0x37) || op == 0x77 ||
+				op == 0xA0 || op == 0xA1 || op == 0xA2 || op == 0xA8 || op == 0xA9 || op == 0xAA ||
+				(op >= 0xC8 && op <= 0xCF);
+		}
+
+		// VEX / EVEX body: opcode, ModRM, optional imm8. `map` is the mmmmm field.
+		Insn DecodeVexBody(const unsigned char* code, std::size_t pos, unsigned map)
+		{
+			Insn insn{};
+			const unsigned char op = code[pos++];
+			unsigned reg = 0;
+			if (map < 1 || map > 3 || !DecodeModRM(code, pos, insn, reg))
+			{
+				return Insn{};
+			}
+			if (map == 3 || (map == 1 && Map1HasImm8(op)))
+			{
+				pos += 1;
+			}
+			insn.kind = InsnKind::Plain;
+			insn.length = pos;
+			return insn;
+		}
+
+		Insn Decode(const unsigned char* code)
+		{
+			Insn insn{};
+			std::size_t pos = 0;
+			bool opsize = false;
+			bool addrsize = false;
+			bool rex_w = false;
+
+			for (; pos < kMaxInsnBytes; ++pos)
+			{
+				const unsigned char b = code[pos];
+				if (b == 0x66)
+				{
+					opsize = true;
+				}
+				else if (b == 0x67)
+				{
+					addrsize = true;
+				}
+				else if (b != 0xF0 && b != 0xF2 && b != 0xF3 &&
+					b != 0x2E && b != 0x36 && b != 0x3E && b != 0x26 && b != 0x64 && b != 0x65)
+				{
+					break;
+				}
+			}
+			if ((code[pos] & 0xF0) == 0x40)
+			{
+				rex_w = (code[pos] & 0x08) != 0;
+				++pos;
+			}
+
+			const unsigned char op = code[pos++];
+			const std::size_t imm_z = opsize ? 2 : 4;
+			std::size_t imm = 0;
+			bool modrm = false;
+			unsigned reg = 0;
+			insn.kind = InsnKind::Plain;
+
+			if (op == 0x0F)
+			{
+				const unsigned char op2 = code[pos++];
+				if (op2 == 0x38 || op2 == 0x3A)
+				{
+					++pos;
+					modrm = true;
+					imm = op2 == 0x3A ? 1 : 0;
+				}
+				else if (op2 >= 0x80 && op2 <= 0x8F)
+				{
+					insn.kind = InsnKind::JccRel;
+					insn.cond = op2 & 0x0F;
+					insn.rel_offset = pos;
+					insn.rel_size = 4;
+					imm = 4;
+				}
+				else if (op2 == 0x04 || op2 == 0x0A || op2 == 0x0C || op2 == 0x36 || op2 == 0x39 ||
+					(op2 >= 0x3B && op2 <= 0x3F))
+				{
+					return Insn{};
+				}
+				else
+				{
+					modrm = !Map1HasNoModRM(op2);
+					imm = Map1HasImm8(op2) ? 1 : 0;
+					insn.padding = op2 == 0x1F;
+				}
+			}
+			else if (op == 0xC5)
+			{
+				return DecodeVexBody(code, pos + 1, 1);
+			}
+			else if (op == 0xC4)
+			{
+				return DecodeVexBody(code, pos + 2, code[pos] & 0x1Fu);
+			}
+			else if (op == 0x62)
+			{
+				return DecodeVexBody(code, pos + 3, code[pos] & 0x07u);
+			}
+			else if (op < 0x40)
+			{
+				const unsigned low = op & 7u;
+				if (low <= 3)
+				{
+					modrm = true;
+				}
+				else if (low == 4)
+				{
+					imm = 1;
+				}
+				else if (low == 5)
+				{
+					imm = imm_z;
+				}
+				else
+				{
+					return Insn{};
+				}
+			}
+			else if (op <= 0x4F)
+			{
+				return Insn{}; // second REX
+			}
+			else if (op <= 0x5F)
+			{
+			}
+			else if (op == 0x63)
+			{
+				modrm = true;
+			}
+			else if (op == 0x68)
+			{
+				imm = imm_z;
+			}
+			else if (op == 0x69)
+			{
+				modrm = true;
+				imm = imm_z;
+			}
+			else if (op == 0x6A)
+			{
+				imm = 1;
+			}
+			else if (op == 0x6B)
+			{
+				modrm = true;
+				imm = 1;
+			}
+			else if (op >= 0x6C && op <= 0x6F)
+			{
+			}
+			else if (op >= 0x70 && op <= 0x7F)
+			{
+				insn.kind = InsnKind::JccRel;
+				insn.cond = op & 0x0F;
+				insn.rel_offset = pos;
+				insn.rel_size = 1;
+				imm = 1;
+			}
+			else if (op == 0x80 || op == 0x83 || op == 0xC0 || op == 0xC1 || op == 0xC6)
+			{
+				modrm = true;
+				imm = 1;
+			}
+			else if (op == 0x81 || op == 0xC7)
+			{
+				modrm = true;
+				imm = imm_z;
+			}
+			else if (op >= 0x84 && op <= 0x8F)
+			{
+				modrm = true;
+			}
+			else if (op >= 0x90 && op <= 0x9F && op != 0x9A)
+			{
+				insn.padding = op == 0x90;
+			}
+			else if (op >= 0xA0 && op <= 0xA3)
+			{
+				imm = addrsize ? 4 : 8;
+			}
+			else if ((op >= 0xA4 && op <= 0xA7) || (op >= 0xAA && op <= 0xAF))
+			{
+			}
+			else if (op == 0xA8)
+			{
+				imm = 1;
+			}
+			else if (op == 0xA9)
+			{
+				imm = imm_z;
+			}
+			else if (op >= 0xB0 && op <= 0xB7)
+			{
+				imm = 1;
+			}
+			else if (op >= 0xB8 && op <= 0xBF)
+			{
+				imm = rex_w ? 8 : imm_z;
+			}
+			else if (op == 0xC2 || op == 0xCA)
+			{
+				insn.kind = InsnKind::Return;
+				imm = 2;
+			}
+			else if (op == 0xC3 || op == 0xCB || op == 0xCF)
+			{
+				insn.kind = InsnKind::Return;
+			}
+			else if (op == 0xC8)
+			{
+				imm = 3;
+			}
+			else if (op == 0xC9 || op == 0xCC || op == 0xF1 || op == 0xF4 || op == 0xF5 || (op >= 0xF8 && op <= 0xFD) ||
+				op == 0xD7 || (op >= 0xEC && op <= 0xEF))
+			{
+				insn.padding = op == 0xCC;
+			}
+			else if (op == 0xCD || (op >= 0xE4 && op <= 0xE7))
+			{
+				imm = 1;
+			}
+			else if ((op >= 0xD0 && op <= 0xD3) || (op >= 0xD8 && op <= 0xDF) || op == 0xFE)
+			{
+				modrm = true;
+			}
+			else if (op >= 0xE0 && op <= 0xE3)
+			{
+				insn.kind = InsnKind::LoopRel;
+				insn.rel_offset = pos;
+				insn.rel_size = 1;
+				imm = 1;
+			}
+			else if (op == 0xE8 || op == 0xE9)
+			{
+				insn.kind = op == 0xE8 ? InsnKind::CallRel : InsnKind::JmpRel;
+				insn.rel_offset = pos;
+				insn.rel_size = 4;
+				imm = 4;
+			}
+			else if (op == 0xEB)
+			{
+				insn.kind = InsnKind::JmpRel;
+				insn.rel_offset = pos;
+				insn.rel_size = 1;
+				imm = 1;
+			}
+			else if (op == 0xF6 || op == 0xF7)
+			{
+				modrm = true;
+			}
+			else if (op == 0xFF)
+			{
+				modrm = true;
+			}
+			else
+			{
+				return Insn{};
+			}
+
+			if (modrm && !DecodeModRM(code, pos, insn, reg))
+			{
+				return Insn{};
+			}
+			if ((op == 0xF6 || op == 0xF7) && reg <= 1)
+			{
+				imm = op == 0xF6 ? 1 : imm_z;
+			}
+			if (op == 0xFF && (reg == 4 || reg == 5))
+			{
+				insn.kind = InsnKind::JmpIndirect;
+			}
+
+			pos += imm;
+			if (pos > kMaxInsnBytes)
+			{
+				return Insn{};
+			}
+			insn.length = pos;
+			return insn;
+		}
+
+		// ---------------------------------------------------------------
+		// Code emission.
+		// ---------------------------------------------------------------
+		constexpr std::size_t kAbsJmpBytes = 14;  // FF 25 00000000 abs64
+		constexpr std::size_t kRelayBytes = 16;   // abs jmp, padded
+		constexpr std::size_t kSlotBytes = 128;   // relay + worst-case trampoline
+
+		void EmitAbs64(std::vector<unsigned char>& out, std::uintptr_t addr)
+		{
+			for (int i = 0; i < 8; ++i)
+			{
+				out.push_back(static_cast<unsigned char>(addr >> (8 * i)));
+			}
+		}
+
+		void EmitAbsJmp(std::vector<unsigned char>& out, std::uintptr_t addr)
+		{
+			out.insert(out.end(), { 0xFF, 0x25, 0x00, 0x00, 0x00, 0x00 });
+			EmitAbs64(out, addr);
+		}
+
+		bool FitsRel32(std::int64_t value)
+		{
+			return value >= std::numeric_limits<std::int32_t>::min() &&
+				value <= std::numeric_limits<std::int32_t>::max();
+		}
+
+		// Relative form when `addr` is in rel32 reach of the instruction end,
+		// otherwise the absolute indirect form. `here` is where out.back()+1
+		// will live at run time.
+		void EmitRel32(std::vector<unsigned char>& out, std::uintptr_t here, std::uintptr_t addr)
+		{
+			const auto rel = static_cast<std::int32_t>(static_cast<std::int64_t>(addr - (here + 4)));
+			const auto* bytes = reinterpret_cast<const unsigned char*>(&rel);
+			out.insert(out.end(), bytes, bytes + sizeof(rel));
+		}
+
+		bool InReach(std::uintptr_t from_end, std::uintptr_t addr)
+		{
+			return FitsRel32(static_cast<std::int64_t>(addr - from_end));
+		}
+
+		void EmitJmp(std::vector<unsigned char>& out, std::uintptr_t base, std::uintptr_t addr)
+		{
+			const std::uintptr_t here = base + out.size();
+			if (InReach(here + 5, addr))
+			{
+				out.push_back(0xE9);
+				EmitRel32(out, here + 1, addr);
+				return;
+			}
+			EmitAbsJmp(out, addr);
+		}
+
+		// call rel32, or: call [rip+2]; jmp +8; abs64 (returns right after it).
+		void EmitCall(std::vector<unsigned char>& out, std::uintptr_t base, std::uintptr_t addr)
+		{
+			const std::uintptr_t here = base + out.size();
+			if (InReach(here + 5, addr))
+			{
+				out.push_back(0xE8);
+				EmitRel32(out, here + 1, addr);
+				return;
+			}
+			out.insert(out.end(), { 0xFF, 0x15, 0x02, 0x00, 0x00, 0x00, 0xEB, 0x08 });
+			EmitAbs64(out, addr);
+		}
+
+		// jcc rel32, or: j!cc +14; jmp [abs64]
+		void EmitJcc(std::vector<unsigned char>& out, std::uintptr_t base, unsigned char cond, std::uintptr_t addr)
+		{
+			const std::uintptr_t here = base + out.size();
+			if (InReach(here + 6, addr))
+			{
+				out.push_back(0x0F);
+				out.push_back(static_cast<unsigned char>(0x80 | cond));
+				EmitRel32(out, here + 2, addr);
+				return;
+			}
+			out.push_back(static_cast<unsigned char>(0x70 | (cond ^ 1u)));
+			out.push_back(static_cast<unsigned char>(kAbsJmpBytes));
+			EmitAbsJmp(out, addr);
+		}
+
+		std::int64_t ReadRel(const unsigned char* p, std::size_t size)
+		{
+			if (size == 1)
+			{
+				return static_cast<std::int8_t>(p[0]);
+			}
+			std::int32_t rel = 0;
+			std::memcpy(&rel, p, sizeof(rel));
+			return rel;
+		}
+
+		// Copy enough whole instructions from `src` to cover the patch, rewriting
+		// position-dependent ones for their new home at `dst`, then jump back.
+		// Returns false when the prologue cannot be relocated safely.
+		bool Relocate(const unsigned char* src, const unsigned char* dst, std::vector<unsigned char>& out)
+		{
+			out.clear();
+			const auto base = reinterpret_cast<std::uintptr_t>(dst);
+			std::size_t pos = 0;
+			bool finished = false;
+			std::vector<std::uintptr_t> branch_targets{};
+
+			while (pos < NativeX86_64Hooker::kPatchBytes)
+			{
+				const Insn insn = Decode(src + pos);
+				if (insn.kind == InsnKind::Invalid)
+				{
+					return false;
+				}
+				if (finished)
+				{
+					// Past a ret/jmp the patch may only cover alignment filler.
+					if (!insn.padding)
+					{
+						return false;
+					}
+					pos += insn.length;
+					continue;
+				}
+
+				const unsigned char* ip = src + pos;
+				const auto next = reinterpret_cast<std::uintptr_t>(ip + insn.length);
+				const std::uintptr_t branch = insn.rel_size == 0
+					? 0
+					: next + static_cast<std::uintptr_t>(ReadRel(ip + insn.rel_offset, insn.rel_size));
+
+				switch (insn.kind)
+				{
+				case InsnKind::Plain:
+				case InsnKind::Return:
+				case InsnKind::JmpIndirect:
+				{
+					const std::size_t at = out.size();
+					out.insert(out.end(), ip, ip + insn.length);
+					if (insn.rip_disp_offset != 0)
+					{
+						const std::int64_t disp = ReadRel(ip + insn.rip_disp_offset, 4);
+						const auto new_next = reinterpret_cast<std::intptr_t>(dst + at + insn.length);
+						const std::int64_t moved = static_cast<std::int64_t>(next) + disp - new_next;
+						if (!FitsRel32(moved))
+						{
+							return false;
+						}
+						const auto rel = static_cast<std::int32_t>(moved);
+						std::memcpy(out.data() + at + insn.rip_disp_offset, &rel, sizeof(rel));
+					}
+					finished = insn.kind != InsnKind::Plain;
+					break;
+				}
+				case InsnKind::JmpRel:
+					EmitJmp(out, base, branch);
+					branch_targets.push_back(branch);
+					finished = true;
+					break;
+				case InsnKind::CallRel:
+					EmitCall(out, base, branch);
+					break;
+				case InsnKind::JccRel:
+					EmitJcc(out, base, insn.cond, branch);
+					branch_targets.push_back(branch);
+					break;
+				case InsnKind::LoopRel:
+				case InsnKind::Invalid:
+					return false;
+				}
+				pos += insn.length;
+			}
+
+			// A branch back into the bytes we overwrite would land inside the
+			// patch (or re-enter the detour, for the entry itself).
+			const auto begin = reinterpret_cast<std::uintptr_t>(src);
+			for (const std::uintptr_t target : branch_targets)
+			{
+				if (target >= begin && target < begin + pos)
+				{
+					return false;
+				}
+			}
+
+			if (!finished)
+			{
+				EmitJmp(out, base, reinterpret_cast<std::uintptr_t>(src + pos));
+			}
+			return out.size() + kRelayBytes <= kSlotBytes;
+		}
+
+		// ---------------------------------------------------------------
+		// Staged code writes: one RWX/RX mprotect pair per contiguous page
+		// run, however many hooks touch it.
+		// ---------------------------------------------------------------
+		class CodeWriter
+		{
+		public:
+			void Stage(void* dst, const void* src, std::size_t bytes)
+			{
+				Write write{};
+				write.dst = static_cast<unsigned char*>(dst);
+				write.bytes.assign(static_cast<const unsigned char*>(src), static_cast<const unsigned char*>(src) + bytes);
+				writes_.push_back(std::move(write));
+			}
+
+			bool Commit()
+			{
+				const auto page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+				std::vector<std::pair<std::uintptr_t, std::uintptr_t>> runs{};
+				std::vector<PatchRange> ranges{};
+				for (const Write& write : writes_)
+				{
+					const auto addr = reinterpret_cast<std::uintptr_t>(write.dst);
+					runs.emplace_back(addr & ~(page - 1), (addr + write.bytes.size() + page - 1) & ~(page - 1));
+					ranges.push_back(PatchRange{ write.dst, write.bytes.size() });
+				}
+				std::sort(runs.begin(), runs.end());
+
+				std::vector<std::pair<std::uintptr_t, std::uintptr_t>> merged{};
+				for (const auto& run : runs)
+				{
+					if (!merged.empty() && run.first <= merged.back().second)
+					{
+						merged.back().second = std::max(merged.back().second, run.second);
+					}
+					else
+					{
+						merged.push_back(run);
+					}
+				}
+
+				// Everything above allocates; nothing in WriteRuns may while
+				// threads are parked, so writes_ is released only afterwards.
+				const bool ok = WriteRuns(merged, ranges);
+				writes_.clear();
+				return ok;
+			}
+
+		private:
+			bool WriteRuns(
+				const std::vector<std::pair<std::uintptr_t, std::uintptr_t>>& merged,
+				const std::vector<PatchRange>& ranges) const
+			{
+				const PatchQuiescence quiescence{ ranges.data(), ranges.size() };
+				if (!quiescence.Safe())
+				{
+					return false;
+				}
+
+				std::size_t unlocked = 0;
+				for (; unlocked < merged.size(); ++unlocked)
+				{
+					const auto& run = merged[unlocked];
+					if (mprotect(reinterpret_cast<void*>(run.first), run.second - run.first,
+						PROT_READ | PROT_WRITE | PROT_EXEC) != 0)
+					{
+						break;
+					}
+				}
+
+				const bool ok = unlocked == merged.size();
+				if (ok)
+				{
+					for (const Write& write : writes_)
+					{
+						Apply(write);
+					}
+				}
+
+				for (std::size_t i = 0; i < unlocked; ++i)
+				{
+					const auto& run = merged[i];
+					(void)mprotect(reinterpret_cast<void*>(run.first), run.second - run.first, PROT_READ | PROT_EXEC);
+				}
+				return ok;
+			}
+
+			struct Write
+			{
+				unsigned char* dst = nullptr;
+				std::vector<unsigned char> bytes{};
+			};
+
+			static void Apply(const Write& write)
+			{
+				const auto addr = reinterpret_cast<std::uintptr_t>(write.dst);
+				const std::size_t offset = addr & 7u;
+				if (write.bytes.size() <= 8 && offset + write.bytes.size() <= 8)
+				{
+					// Fits one aligned qword: publish the whole patch with a
+					// single store so no thread sees a half-written jump.
+					auto* word = reinterpret_cast<std::uint64_t*>(addr - offset);
+					std::uint64_t value = __atomic_load_n(word, __ATOMIC_RELAXED);
+					std::memcpy(reinterpret_cast<unsigned char*>(&value) + offset, write.bytes.data(), write.bytes.size());
+					__atomic_store_n(word, value, __ATOMIC_SEQ_CST);
+				}
+				else
+				{
+					std::memcpy(write.dst, write.bytes.data(), write.bytes.size());
+				}
+				char* code = reinterpret_cast<char*>(write.dst);
+				__builtin___clear_cache(code, code + write.bytes.size());
+			}
+
+			std::vector<Write> writes_{};
+		};
+
+		constexpr std::size_t kChunkBytes = 64 * 1024;
+		// Stay clear of the exact rel32 limit so every byte of a slot is reachable.
+		constexpr std::int64_t kReach = std::numeric_limits<std::int32_t>::max() - static_cast<std::int64_t>(kChunkBytes);
+
+		bool Reachable(const unsigned char* from, const unsigned char* to, std::size_t bytes)
+		{
+			const auto a = reinterpret_cast<std::intptr_t>(from);
+			const auto lo = reinterpret_cast<std::intptr_t>(to);
+			const auto hi = lo + static_cast<std::intptr_t>(bytes);
+			return std::max(a > lo ? a - lo : lo - a, a > hi ? a - hi : hi - a) < kReach;
+		}
+
+		unsigned char* MapChunkNear(const unsigned char* near)
+		{
+			constexpr std::uintptr_t kStep = 1u << 20;
+			constexpr std::uintptr_t kMinAddress = 1u << 16;
+			const auto origin = reinterpret_cast<std::uintptr_t>(near) & ~(kStep - 1);
+
+#ifdef MAP_FIXED_NOREPLACE
+			constexpr int kFlags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE;
+#else
+			constexpr int kFlags = MAP_PRIVATE | MAP_ANONYMOUS;
+#endif
+			const std::uintptr_t probes = static_cast<std::uintptr_t>(kReach) / kStep;
+			for (std::uintptr_t i = 1; i < probes; ++i)
+			{
+				for (int dir = -1; dir <= 1; dir += 2)
+				{
+					const std::uintptr_t delta = i * kStep;
+					if (dir < 0 && origin < delta + kMinAddress)
+					{
+						continue;
+					}
+					const std::uintptr_t hint = dir < 0 ? origin - delta : origin + delta;
+					void* mem = mmap(reinterpret_cast<void*>(hint), kChunkBytes, PROT_READ | PROT_EXEC, kFlags, -1, 0);
+					if (mem == MAP_FAILED)
+					{
+						continue;
+					}
+					auto* chunk = static_cast<unsigned char*>(mem);
+					if (Reachable(near, chunk, kChunkBytes))
+					{
+						return chunk;
+					}
+					munmap(mem, kChunkBytes);
+				}
+			}
+			return nullptr;
+		}
+	}
+
+	unsigned char* NativeX86_64Hooker::AllocateNear(const unsigned char* near, std::size_t bytes)
+	{
+		for (Chunk& chunk : chunks_)
+		{
+			if (chunk.size - chunk.used >= bytes && Reachable(near, chunk.base + chunk.used, bytes))
+			{
+				unsigned char* out = chunk.base + chunk.used;
+				chunk.used += bytes;
+				return out;
+			}
+		}
+
+		unsigned char* base = MapChunkNear(near);
+		if (base == nullptr)
+		{
+			return nullptr;
+		}
+		chunks_.push_back(Chunk{ base, kChunkBytes, bytes });
+		return base;
+	}
+
+	bool NativeX86_64Hooker::CreateHook(void* target, void* detour, void** origin)
+	{
+		if (target == nullptr || detour == nullptr || origin == nullptr)
+		{
+			return false;
+		}
+
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		if (hooks_.find(target) != hooks_.end())
+		{
+			return false;
+		}
+
+		// Dry run in place: rejects undecodable prologues before any memory
+		// is carved from the pool (only reach can still fail below).
+		const auto* src = static_cast<const unsigned char*>(target);
+		std::vector<unsigned char> trampoline{};
+		if (!Relocate(src, src, trampoline))
+		{
+			return false;
+		}
+
+		unsigned char* slot = AllocateNear(src, kSlotBytes);
+		if (slot == nullptr)
+		{
+			return false;
+		}
+		Record record{};
+		record.relay = slot;
+		record.trampoline = slot + kRelayBytes;
+		if (!Relocate(src, record.trampoline, trampoline))
+		{
+			return false;
+		}
+
+		// Jump straight to the detour when it is in rel32 reach (the common
+		// case: same image); otherwise through the absolute relay in the slot.
+		const auto patch_end = reinterpret_cast<std::uintptr_t>(src + kPatchBytes);
+		auto jump_to = reinterpret_cast<std::uintptr_t>(detour);
+		if (!InReach(patch_end, jump_to))
+		{
+			std::vector<unsigned char> relay{};
+			EmitAbsJmp(relay, jump_to);
+			pool_writes_.push_back(PoolWrite{ record.relay, std::move(relay), target, "relay" });
+			jump_to = reinterpret_cast<std::uintptr_t>(record.relay);
+		}
+		pool_writes_.push_back(PoolWrite{ record.trampoline, std::move(trampoline), target, "trampoline" });
+
+		record.patch[0] = 0xE9;
+		const auto rel = static_cast<std::int32_t>(static_cast<std::int64_t>(jump_to - patch_end));
+		std::memcpy(record.patch + 1, &rel, sizeof(rel));
+		std::memcpy(record.original, src, kPatchBytes);
+
+		hooks_.emplace(target, record);
+		*origin = record.trampoline;
+		return true;
+	}
+
+	bool NativeX86_64Hooker::SwitchLocked(const std::vector<void*>& targets, bool enable)
+	{
+		CodeWriter writer{};
+		for (const PoolWrite& write : pool_writes_)
+		{
+			writer.Stage(write.dst, write.bytes.data(), write.bytes.size());
+		}
+		for (void* target : targets)
+		{
+			const Record& record = hooks_.at(target);
+			writer.Stage(target, enable ? record.patch : record.original, kPatchBytes);
+		}
+		if (!writer.Commit())
+		{
+			return false;
+		}
+		for (const PoolWrite& write : pool_writes_)
+		{
+			RegisterPerfRegion(write.dst, write.bytes.size(), write.target, write.role);
+		}
+		pool_writes_.clear();
+		for (void* target : targets)
+		{
+			hooks_.at(target).enabled = enable;
+		}
+		return true;
+	}
+
+	bool NativeX86_64Hooker::EnableHook(void* target)
+	{
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		auto it = hooks_.find(target);
+		if (it == hooks_.end())
+		{
+			return false;
+		}
+		if (it->second.enabled)
+		{
+			return true;
+		}
+		return SwitchLocked({ target }, true);
+	}
+
+	bool NativeX86_64Hooker::DisableHook(void* target)
+	{
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		auto it = hooks_.find(target);
+		if (it == hooks_.end())
+		{
+			return false;
+		}
+		// Still flush staged pool code: the trampoline must be callable.
+		return SwitchLocked(it->second.enabled ? std::vector<void*>{ target } : std::vector<void*>{}, false);
+	}
+
+	bool NativeX86_64Hooker::QueueEnableHook(void* target)
+	{
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		if (hooks_.find(target) == hooks_.end())
+		{
+			return false;
+		}
+		queued_.push_back(target);
+		return true;
+	}
+
+	bool NativeX86_64Hooker::ApplyQueued()
+	{
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		std::vector<void*> targets{};
+		targets.reserve(queued_.size());
+		for (void* target : queued_)
+		{
+			// Removed or already enabled since it was queued.
+			auto it = hooks_.find(target);
+			if (it != hooks_.end() && !it->second.enabled)
+			{
+				targets.push_back(target);
+			}
+		}
+		queued_.clear();
+		return SwitchLocked(targets, true);
+	}
+
+	bool NativeX86_64Hooker::RemoveHook(void* target)
+	{
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		auto it = hooks_.find(target);
+		if (it == hooks_.end())
+		{
+			return false;
+		}
+		if (it->second.enabled)
+		{
+			CodeWriter writer{};
+			writer.Stage(target, it->second.original, kPatchBytes);
+			if (!writer.Commit())
+			{
+				return false;
+			}
+		}
+		// The pool slot is not recycled: a thread may still be running the
+		// trampoline of a just-removed hook.
+		hooks_.erase(it);
+		queued_.erase(std::remove(queued_.begin(), queued_.end(), target), queued_.end());
+		return true;
+	}
+}
+
+cpp::blackmagic::hook::Hooker& cpp::blackmagic::hook::Hooker::GetInstance()
+{
+	static NativeX86_64Hooker instance{};
+	return instance;
+}
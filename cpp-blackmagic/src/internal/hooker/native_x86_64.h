@@ -0,0 +1,84 @@
+// native hooker, for linux/android x86_64 (no third-party dependency)
+//
+// Layout of one hook:
+//   target:     E9 rel32 -> detour, or -> relay when the detour is out of
+//               rel32 reach (5 bytes, written on enable)
+//   relay:      FF 25 [abs64 detour]                 (pool, within +-2GB of target)
+//   trampoline: relocated prologue + E9 rel32 back to target+n (pool, same slot)
+//
+// The pool is carved from 64 KiB executable chunks mapped near their targets,
+// so the patch is always a 5-byte rel32 jump regardless of where the detour
+// lives. Code writes are staged and applied with one mprotect pair per page run.
+//
+// CreateHook only stages the relay/trampoline bytes; they are written together
+// with the next enable/disable (or ApplyQueued), so a batch of N hooks costs
+// one protection flip of the pool and one per target page run, not N of each.
+// The trampoline returned in *origin is therefore callable only once the hook
+// has been enabled or disabled at least once.
+#ifndef __CPPBM_HOOKER_NATIVE_X86_64_H__
+#define __CPPBM_HOOKER_NATIVE_X86_64_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "cppbm/internal/hook/hooker.h"
+
+namespace cpp::blackmagic::hook
+{
+	class NativeX86_64Hooker : public Hooker
+	{
+	public:
+		static constexpr std::size_t kPatchBytes = 5;
+
+		bool CreateHook(void* target, void* detour, void** origin) override;
+		bool EnableHook(void* target) override;
+		bool DisableHook(void* target) override;
+		bool RemoveHook(void* target) override;
+		bool QueueEnableHook(void* target) override;
+		bool ApplyQueued() override;
+
+	private:
+		struct Chunk
+		{
+			unsigned char* base = nullptr;
+			std::size_t size = 0;
+			std::size_t used = 0;
+		};
+
+		struct Record
+		{
+			unsigned char* relay = nullptr;
+			unsigned char* trampoline = nullptr;
+			unsigned char original[kPatchBytes]{};
+			unsigned char patch[kPatchBytes]{};
+			bool enabled = false;
+		};
+
+		struct PoolWrite
+		{
+			unsigned char* dst = nullptr;
+			std::vector<unsigned char> bytes{};
+			// Named for profilers once written (see perf_map.h).
+			void* target = nullptr;
+			const char* role = nullptr;
+		};
+
+		// Carve `bytes` of executable memory within rel32 reach of `near`.
+		unsigned char* AllocateNear(const unsigned char* near, std::size_t bytes);
+
+		// Write the staged pool code plus the patch (enable) or original bytes
+		// of every target in one staged commit. Caller holds mtx_.
+		bool SwitchLocked(const std::vector<void*>& targets, bool enable);
+
+		std::mutex mtx_{};
+		std::vector<Chunk> chunks_{};
+		std::unordered_map<void*, Record> hooks_{};
+		std::vector<PoolWrite> pool_writes_{};
+		std::vector<void*> queued_{};
+	};
+}
+
+#endif // __CPPBM_HOOKER_NATIVE_X86_64_H__
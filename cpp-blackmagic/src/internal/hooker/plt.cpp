@@ -0,0 +1,499 @@
+// plt/got hooker, for linux/android (see plt.h)
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <dlfcn.h>
+#include <elf.h>
+#include <link.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "plt.h"
+
+namespace cpp::blackmagic::hook
+{
+	namespace
+	{
+#if defined(__x86_64__)
+		constexpr unsigned long kJumpSlot = R_X86_64_JUMP_SLOT;
+		constexpr unsigned long kGlobDat = R_X86_64_GLOB_DAT;
+#elif defined(__i386__)
+		constexpr unsigned long kJumpSlot = R_386_JMP_SLOT;
+		constexpr unsigned long kGlobDat = R_386_GLOB_DAT;
+#elif defined(__aarch64__)
+		constexpr unsigned long kJumpSlot = R_AARCH64_JUMP_SLOT;
+		constexpr unsigned long kGlobDat = R_AARCH64_GLOB_DAT;
+#elif defined(__arm__)
+		constexpr unsigned long kJumpSlot = R_ARM_JUMP_SLOT;
+		constexpr unsigned long kGlobDat = R_ARM_GLOB_DAT;
+#else
+#error "plt hooker: unsupported architecture"
+#endif
+
+#if defined(__LP64__)
+		inline unsigned long RelSym(ElfW(Xword) info) { return ELF64_R_SYM(info); }
+		inline unsigned long RelType(ElfW(Xword) info) { return ELF64_R_TYPE(info); }
+#else
+		inline unsigned long RelSym(ElfW(Word) info) { return ELF32_R_SYM(info); }
+		inline unsigned long RelType(ElfW(Word) info) { return ELF32_R_TYPE(info); }
+#endif
+
+		struct Range
+		{
+			std::uintptr_t begin = 0;
+			std::uintptr_t end = 0;
+
+			[[nodiscard]] bool Contains(std::uintptr_t addr) const
+			{
+				return addr >= begin && addr < end;
+			}
+		};
+
+		// A relocation table: .rela.plt (DT_JMPREL) or .rela.dyn (DT_RELA / DT_REL).
+		struct RelTable
+		{
+			std::uintptr_t address = 0;
+			std::size_t bytes = 0;
+			bool rela = true;
+		};
+
+		// What one loaded object needs for GOT slot lookup.
+		struct ObjectView
+		{
+			std::vector<Range> loads{};
+			Range relro{};
+			const ElfW(Sym)* symtab = nullptr;
+			const char* strtab = nullptr;
+			RelTable plt{};
+			RelTable dyn{};
+
+			[[nodiscard]] bool Contains(std::uintptr_t addr) const
+			{
+				for (const Range& range : loads)
+				{
+					if (range.Contains(addr))
+					{
+						return true;
+					}
+				}
+				return false;
+			}
+		};
+
+		// glibc relocates d_ptr entries in place; bionic/musl leave them as
+		// link-time addresses.
+		std::uintptr_t DynAddress(std::uintptr_t base, ElfW(Addr) ptr)
+		{
+			return ptr < base ? base + ptr : ptr;
+		}
+
+		bool ParseObject(const dl_phdr_info* info, ObjectView& out)
+		{
+			const std::uintptr_t base = info->dlpi_addr;
+			const ElfW(Dyn)* dynamic = nullptr;
+			for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i)
+			{
+				const ElfW(Phdr)& phdr = info->dlpi_phdr[i];
+				const std::uintptr_t begin = base + phdr.p_vaddr;
+				if (phdr.p_type == PT_LOAD)
+				{
+					out.loads.push_back(Range{ begin, begin + phdr.p_memsz });
+				}
+				else if (phdr.p_type == PT_GNU_RELRO)
+				{
+					out.relro = Range{ begin, begin + phdr.p_memsz };
+				}
+				else if (phdr.p_type == PT_DYNAMIC)
+				{
+					dynamic = reinterpret_cast<const ElfW(Dyn)*>(begin);
+				}
+			}
+			if (dynamic == nullptr)
+			{
+				return false;
+			}
+
+			for (const ElfW(Dyn)* dyn = dynamic; dyn->d_tag != DT_NULL; ++dyn)
+			{
+				switch (dyn->d_tag)
+				{
+				case DT_SYMTAB:
+					out.symtab = reinterpret_cast<const ElfW(Sym)*>(DynAddress(base, dyn->d_un.d_ptr));
+					break;
+				case DT_STRTAB:
+					out.strtab = reinterpret_cast<const char*>(DynAddress(base, dyn->d_un.d_ptr));
+					break;
+				case DT_JMPREL:
+					out.plt.address = DynAddress(base, dyn->d_un.d_ptr);
+					break;
+				case DT_PLTRELSZ:
+					out.plt.bytes = dyn->d_un.d_val;
+					break;
+				case DT_PLTREL:
+					out.plt.rela = dyn->d_un.d_val == DT_RELA;
+					break;
+				case DT_RELA:
+					out.dyn.address = DynAddress(base, dyn->d_un.d_ptr);
+					out.dyn.rela = true;
+					break;
+				case DT_RELASZ:
+				case DT_RELSZ:
+					out.dyn.bytes = dyn->d_un.d_val;
+					break;
+				case DT_REL:
+					out.dyn.address = DynAddress(base, dyn->d_un.d_ptr);
+					out.dyn.rela = false;
+					break;
+				default:
+					break;
+				}
+			}
+			return out.symtab != nullptr && out.strtab != nullptr &&
+				((out.plt.address != 0 && out.plt.bytes != 0) || (out.dyn.address != 0 && out.dyn.bytes != 0));
+		}
+
+		std::vector<std::pair<std::uintptr_t, ObjectView>> LoadedObjects()
+		{
+			std::vector<std::pair<std::uintptr_t, ObjectView>> objects{};
+			dl_iterate_phdr([](dl_phdr_info* info, std::size_t, void* data)
+				{
+					auto& out = *static_cast<std::vector<std::pair<std::uintptr_t, ObjectView>>*>(data);
+					ObjectView view{};
+					if (ParseObject(info, view))
+					{
+						out.emplace_back(info->dlpi_addr, std::move(view));
+					}
+					return 0;
+				}, &objects);
+			return objects;
+		}
+
+		// Call fn(slot, lazy) for every JUMP_SLOT / GLOB_DAT relocation importing
+		// `symbol`; `lazy` marks JUMP_SLOTs, which may still be unbound.
+		template <typename Rel, typename Fn>
+		void ForEachRel(std::uintptr_t base, const ObjectView& view, const RelTable& table, const char* symbol, Fn&& fn)
+		{
+			const auto* rels = reinterpret_cast<const Rel*>(table.address);
+			const std::size_t count = table.bytes / sizeof(Rel);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const unsigned long type = RelType(rels[i].r_info);
+				if ((type != kJumpSlot && type != kGlobDat) || RelSym(rels[i].r_info) == 0)
+				{
+					continue;
+				}
+				const ElfW(Sym)& sym = view.symtab[RelSym(rels[i].r_info)];
+				if (std::strcmp(view.strtab + sym.st_name, symbol) == 0)
+				{
+					fn(reinterpret_cast<void**>(base + rels[i].r_offset), type == kJumpSlot);
+				}
+			}
+		}
+
+		template <typename Fn>
+		void ForEachSlot(std::uintptr_t base, const ObjectView& view, const char* symbol, Fn&& fn)
+		{
+			for (const RelTable* table : { &view.plt, &view.dyn })
+			{
+				if (table->address == 0 || table->bytes == 0)
+				{
+					continue;
+				}
+				if (table->rela)
+				{
+					ForEachRel<ElfW(Rela)>(base, view, *table, symbol, fn);
+				}
+				else
+				{
+					ForEachRel<ElfW(Rel)>(base, view, *table, symbol, fn);
+				}
+			}
+		}
+
+		// Slots are naturally aligned pointers: one atomic store publishes the
+		// new callee. Slots under full RELRO are read-only and get unlocked
+		// just for the store.
+		bool WriteSlot(void** slot, void* value, const ObjectView& view)
+		{
+			const auto addr = reinterpret_cast<std::uintptr_t>(slot);
+			if (!view.relro.Contains(addr))
+			{
+				__atomic_store_n(slot, value, __ATOMIC_SEQ_CST);
+				return true;
+			}
+
+			const auto page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+			void* begin = reinterpret_cast<void*>(addr & ~(page - 1));
+			const std::size_t span = ((addr + sizeof(void*) + page - 1) & ~(page - 1)) - (addr & ~(page - 1));
+			if (mprotect(begin, span, PROT_READ | PROT_WRITE) != 0)
+			{
+				return false;
+			}
+			__atomic_store_n(slot, value, __ATOMIC_SEQ_CST);
+			(void)mprotect(begin, span, PROT_READ);
+			return true;
+		}
+
+		using DlopenFn = void* (*)(const char*, int);
+
+		std::atomic<PltHooker*> g_dlopen_owner{ nullptr };
+		std::atomic<DlopenFn> g_real_dlopen{ nullptr };
+		std::atomic<PltHooker::LoadListener> g_load_listener{ nullptr };
+
+		void* DlopenDetour(const char* file, int mode)
+		{
+			void* handle = g_real_dlopen.load(std::memory_order_acquire)(file, mode);
+			if (handle != nullptr)
+			{
+				if (PltHooker* owner = g_dlopen_owner.load(std::memory_order_acquire))
+				{
+					(void)owner->Rescan();
+				}
+				if (PltHooker::LoadListener listener = g_load_listener.load(std::memory_order_acquire))
+				{
+					listener();
+				}
+			}
+			return handle;
+		}
+	}
+
+	PltHooker::PltHooker() = default;
+
+	PltHooker::~PltHooker()
+	{
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		for (auto& [target, record] : hooks_)
+		{
+			(void)RestoreLocked(record);
+		}
+		if (dlopen_target_ != nullptr)
+		{
+			(void)RestoreLocked(dlopen_hook_);
+			PltHooker* self = this;
+			g_dlopen_owner.compare_exchange_strong(self, nullptr, std::memory_order_acq_rel);
+		}
+	}
+
+	bool PltHooker::ApplyLocked(void* target, Record& record)
+	{
+		const auto real = reinterpret_cast<std::uintptr_t>(target);
+		bool ok = true;
+		for (const auto& [base, view] : LoadedObjects())
+		{
+			ForEachSlot(base, view, record.symbol.c_str(), [&](void** slot, bool lazy)
+				{
+					void* current = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+					if (current == record.detour)
+					{
+						return;
+					}
+					// Bound to the target, or not bound yet (lazy binding: a
+					// JUMP_SLOT still points into this object's own PLT).
+					// Anything else resolves the name to a different definition.
+					const auto value = reinterpret_cast<std::uintptr_t>(current);
+					if (value != real && !(lazy && view.Contains(value)))
+					{
+						return;
+					}
+					if (!WriteSlot(slot, record.detour, view))
+					{
+						ok = false;
+						return;
+					}
+					record.slots.push_back(Slot{ slot, current });
+				});
+		}
+		return ok;
+	}
+
+	bool PltHooker::RestoreLocked(Record& record)
+	{
+		const auto objects = LoadedObjects();
+		bool ok = true;
+		for (const Slot& slot : record.slots)
+		{
+			const auto addr = reinterpret_cast<std::uintptr_t>(slot.address);
+			for (const auto& [base, view] : objects)
+			{
+				if (!view.Contains(addr))
+				{
+					continue;
+				}
+				// Skip slots of an object unloaded meanwhile (and whatever
+				// reuses its address now), or rewritten by someone else.
+				if (__atomic_load_n(slot.address, __ATOMIC_ACQUIRE) == record.detour &&
+					!WriteSlot(slot.address, slot.saved, view))
+				{
+					ok = false;
+				}
+				break;
+			}
+		}
+		record.slots.clear();
+		return ok;
+	}
+
+	bool PltHooker::EnsureDlopenHookLocked()
+	{
+		if (dlopen_target_ != nullptr)
+		{
+			return true;
+		}
+		PltHooker* expected = nullptr;
+		if (!g_dlopen_owner.compare_exchange_strong(expected, this, std::memory_order_acq_rel))
+		{
+			// Another instance already re-scans on dlopen.
+			return true;
+		}
+
+		// dlsym, not &dlopen: in a non-PIE image &dlopen is the local PLT stub.
+		void* real = dlsym(RTLD_DEFAULT, "dlopen");
+		if (real == nullptr)
+		{
+			g_dlopen_owner.store(nullptr, std::memory_order_release);
+			return false;
+		}
+		g_real_dlopen.store(reinterpret_cast<DlopenFn>(real), std::memory_order_release);
+		dlopen_hook_.symbol = "dlopen";
+		dlopen_hook_.detour = reinterpret_cast<void*>(&DlopenDetour);
+		dlopen_hook_.enabled = true;
+		dlopen_target_ = real;
+		return ApplyLocked(real, dlopen_hook_);
+	}
+
+	bool PltHooker::CreateHook(void* target, void* detour, void** origin)
+	{
+		if (target == nullptr || detour == nullptr || origin == nullptr)
+		{
+			return false;
+		}
+
+		// PLT slots are matched by symbol name: the target must be an exported
+		// function, named exactly at its address.
+		Dl_info info{};
+		if (dladdr(target, &info) == 0 || info.dli_sname == nullptr || info.dli_saddr != target)
+		{
+			return false;
+		}
+
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		if (hooks_.find(target) != hooks_.end())
+		{
+			return false;
+		}
+		Record record{};
+		record.symbol = info.dli_sname;
+		record.detour = detour;
+		hooks_.emplace(target, std::move(record));
+
+		// Nothing to relocate: calling the original is calling the target.
+		*origin = target;
+		return true;
+	}
+
+	bool PltHooker::EnableHook(void* target)
+	{
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		auto it = hooks_.find(target);
+		if (it == hooks_.end())
+		{
+			return false;
+		}
+		if (it->second.enabled)
+		{
+			return true;
+		}
+		if (!EnsureDlopenHookLocked() || !ApplyLocked(target, it->second))
+		{
+			(void)RestoreLocked(it->second);
+			return false;
+		}
+		// No importer loaded yet: only this instance's dlopen() re-scan can
+		// patch one later. Another owner never re-applies our hooks, so an
+		// enable that redirects nothing would be a silent no-op.
+		if (it->second.slots.empty() && g_dlopen_owner.load(std::memory_order_acquire) != this)
+		{
+			return false;
+		}
+		it->second.enabled = true;
+		return true;
+	}
+
+	bool PltHooker::DisableHook(void* target)
+	{
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		auto it = hooks_.find(target);
+		if (it == hooks_.end())
+		{
+			return false;
+		}
+		if (!it->second.enabled)
+		{
+			return true;
+		}
+		if (!RestoreLocked(it->second))
+		{
+			return false;
+		}
+		it->second.enabled = false;
+		return true;
+	}
+
+	bool PltHooker::RemoveHook(void* target)
+	{
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		auto it = hooks_.find(target);
+		if (it == hooks_.end())
+		{
+			return false;
+		}
+		if (it->second.enabled && !RestoreLocked(it->second))
+		{
+			return false;
+		}
+		hooks_.erase(it);
+		return true;
+	}
+
+	bool PltHooker::Rescan()
+	{
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		bool ok = true;
+		for (auto& [target, record] : hooks_)
+		{
+			if (record.enabled)
+			{
+				ok = ApplyLocked(target, record) && ok;
+			}
+		}
+		if (dlopen_target_ != nullptr)
+		{
+			ok = ApplyLocked(dlopen_target_, dlopen_hook_) && ok;
+		}
+		return ok;
+	}
+
+	std::size_t PltHooker::PatchedSlots(void* target)
+	{
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		auto it = hooks_.find(target);
+		return it == hooks_.end() ? 0 : it->second.slots.size();
+	}
+
+	bool PltHooker::WatchLoads(LoadListener listener)
+	{
+		g_load_listener.store(listener, std::memory_order_release);
+		std::lock_guard<std::mutex> guard{ mtx_ };
+		return EnsureDlopenHookLocked();
+	}
+}
+
+#ifdef CPPBM_HOOK_PLT_BACKEND
+cpp::blackmagic::hook::Hooker& cpp::blackmagic::hook::Hooker::GetInstance()
+{
+	static PltHooker instance{};
+	return instance;
+}
+#endif // CPPBM_HOOK_PLT_BACKEND
@@ -0,0 +1,95 @@
+// plt/got hooker, for linux/android (no third-party dependency)
+//
+// Redirects calls that cross a shared-object boundary by rewriting the GOT
+// slots that import the target's symbol, in every loaded object: JUMP_SLOT
+// entries of .got.plt and GLOB_DAT entries of .got (used by -fno-plt call
+// sites, and by PLT stubs of functions whose address is also taken, as with
+// every decorated target). Nothing in .text is written and
+// no code is relocated: the original is the target itself, so the "trampoline"
+// handed back in *origin is just the real function address.
+//
+// Scope (by design of GOT hooking):
+// - the target must be an exported function of a loaded object (dladdr()
+//   must name it exactly);
+// - only calls made through the GOT are redirected; direct calls inside
+//   the defining object keep reaching the original;
+// - while enabled, taking the function's address in an importing object
+//   yields the detour (the GLOB_DAT slot holds it).
+//
+// Objects loaded later are covered by intercepting dlopen() the same way:
+// after each successful dlopen every enabled hook is re-applied with a fresh
+// dl_iterate_phdr() scan. Only the first PltHooker instance to enable a hook
+// owns that interception. Because of it, glibc sees the hooker's object as
+// the dlopen() caller when resolving $ORIGIN/RUNPATH of relative names.
+//
+// EnableHook() fails when it redirects no slot and the instance does not own
+// that interception (nothing would ever patch the hook). On the owner such a
+// hook stays pending until an importing object is loaded; PatchedSlots() == 0
+// tells the two apart from a live one.
+#ifndef __CPPBM_HOOKER_PLT_H__
+#define __CPPBM_HOOKER_PLT_H__
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cppbm/internal/hook/hooker.h"
+
+namespace cpp::blackmagic::hook
+{
+	class PltHooker : public Hooker
+	{
+	public:
+		PltHooker();
+		~PltHooker() override;
+
+		bool CreateHook(void* target, void* detour, void** origin) override;
+		bool EnableHook(void* target) override;
+		bool DisableHook(void* target) override;
+		bool RemoveHook(void* target) override;
+
+		// Re-apply every enabled hook to objects loaded since the last scan.
+		// Called from the dlopen() interception; public for loaders that map
+		// objects some other way.
+		bool Rescan();
+
+		// Number of relocation slots currently redirected for `target`.
+		std::size_t PatchedSlots(void* target);
+
+		// Call `listener` after every successful dlopen(), once the hooks are
+		// re-applied; installs the dlopen() interception if no instance owns
+		// it yet. One listener per process (a later call replaces it).
+		using LoadListener = void (*)();
+		bool WatchLoads(LoadListener listener);
+
+	private:
+		struct Slot
+		{
+			void** address = nullptr;
+			void* saved = nullptr;
+		};
+
+		struct Record
+		{
+			std::string symbol{};
+			void* detour = nullptr;
+			bool enabled = false;
+			std::vector<Slot> slots{};
+		};
+
+		// Redirect every not-yet-patched slot that imports `record`'s symbol.
+		bool ApplyLocked(void* target, Record& record);
+		// Put saved values back into slots of objects that are still loaded.
+		bool RestoreLocked(Record& record);
+		bool EnsureDlopenHookLocked();
+
+		std::mutex mtx_{};
+		std::unordered_map<void*, Record> hooks_{};
+		// dlopen() interception, kept apart from user hooks on dlopen itself.
+		void* dlopen_target_ = nullptr;
+		Record dlopen_hook_{};
+	};
+}
+
+#endif // __CPPBM_HOOKER_PLT_H__
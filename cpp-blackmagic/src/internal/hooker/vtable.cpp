@@ -0,0 +1,290 @@
+// vtable-slot hooker and vtable lookup (see cppbm/internal/hook/vtable.h)
+//
+// A hook is one pointer in a vtable: enable stores the detour, disable stores
+// the saved implementation back. Nothing is relocated, so the "trampoline"
+// handed back in *origin is the implementation itself.
+//
+// Vtables live in read-only memory (.data.rel.ro under RELRO, or .rodata);
+// the slot's page is unlocked just for the store and its protection is taken
+// from the program headers of the object that contains it.
+//
+// Lookup (Itanium ABI): a primary vtable is laid out as
+//   [offset-to-top = 0][&typeid(T)][slot 0][slot 1]...
+//                                   ^ address point
+// so the address point follows the first pointer-aligned occurrence of
+// &typeid(T) preceded by a zero, searched in the non-executable loadable
+// segments of every loaded object.
+#include <cstdint>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <link.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define CPPBM_VTABLE_ELF
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+#include "cppbm/internal/hook/vtable.h"
+
+namespace cpp::blackmagic::hook
+{
+	namespace
+	{
+#ifdef CPPBM_VTABLE_ELF
+		struct Segment
+		{
+			std::uintptr_t begin = 0;
+			std::uintptr_t end = 0;
+			int prot = 0;
+		};
+
+		// Protection of the page holding `addr`, from the program headers
+		// (PT_GNU_RELRO overrides the PT_LOAD flags). false when `addr` is not
+		// in any loaded object.
+		bool ProtectionOf(std::uintptr_t addr, int& prot)
+		{
+			struct Query
+			{
+				std::uintptr_t addr = 0;
+				int prot = 0;
+				bool found = false;
+			} query{ addr };
+
+			dl_iterate_phdr([](dl_phdr_info* info, std::size_t, void* data)
+				{
+					auto& q = *static_cast<Query*>(data);
+					bool in_load = false;
+					bool in_relro = false;
+					int prot = 0;
+					for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i)
+					{
+						const ElfW(Phdr)& ph = info->dlpi_phdr[i];
+						const std::uintptr_t begin = info->dlpi_addr + ph.p_vaddr;
+						if (q.addr < begin || q.addr >= begin + ph.p_memsz)
+						{
+							continue;
+						}
+						if (ph.p_type == PT_LOAD)
+						{
+							in_load = true;
+							prot = ((ph.p_flags & PF_R) ? PROT_READ : 0) |
+								((ph.p_flags & PF_W) ? PROT_WRITE : 0) |
+								((ph.p_flags & PF_X) ? PROT_EXEC : 0);
+						}
+						else if (ph.p_type == PT_GNU_RELRO)
+						{
+							in_relro = true;
+						}
+					}
+					if (!in_load)
+					{
+						return 0;
+					}
+					q.prot = in_relro ? PROT_READ : prot;
+					q.found = true;
+					return 1;
+				}, &query);
+
+			prot = query.prot;
+			return query.found;
+		}
+
+		void** ScanForVtable(const void* type_info)
+		{
+			struct Query
+			{
+				const void* type_info = nullptr;
+				void** found = nullptr;
+			} query{ type_info };
+
+			dl_iterate_phdr([](dl_phdr_info* info, std::size_t, void* data)
+				{
+					auto& q = *static_cast<Query*>(data);
+					for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i)
+					{
+						const ElfW(Phdr)& ph = info->dlpi_phdr[i];
+						if (ph.p_type != PT_LOAD || (ph.p_flags & PF_X) != 0 || (ph.p_flags & PF_R) == 0)
+						{
+							continue;
+						}
+						const std::uintptr_t begin = info->dlpi_addr + ph.p_vaddr;
+						auto* words = reinterpret_cast<const void* const*>(
+							(begin + sizeof(void*) - 1) & ~(sizeof(void*) - 1));
+						auto* end = reinterpret_cast<const void* const*>(begin + ph.p_filesz);
+						for (const void* const* w = words + 1; w + 1 < end; ++w)
+						{
+							if (*w == q.type_info && w[-1] == nullptr)
+							{
+								q.found = reinterpret_cast<void**>(reinterpret_cast<std::uintptr_t>(w + 1));
+								return 1;
+							}
+						}
+					}
+					return 0;
+				}, &query);
+			return query.found;
+		}
+#endif
+
+		// Slots are naturally aligned pointers: one atomic store publishes the
+		// new callee.
+		bool WriteSlot(void** slot, void* value)
+		{
+#ifdef CPPBM_VTABLE_ELF
+			const auto addr = reinterpret_cast<std::uintptr_t>(slot);
+			int prot = 0;
+			if (!ProtectionOf(addr, prot))
+			{
+				return false;
+			}
+			if ((prot & PROT_WRITE) != 0)
+			{
+				__atomic_store_n(slot, value, __ATOMIC_SEQ_CST);
+				return true;
+			}
+
+			const auto page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+			void* begin = reinterpret_cast<void*>(addr & ~(page - 1));
+			const std::size_t span = ((addr + sizeof(void*) + page - 1) & ~(page - 1)) - (addr & ~(page - 1));
+			if (mprotect(begin, span, prot | PROT_READ | PROT_WRITE) != 0)
+			{
+				return false;
+			}
+			__atomic_store_n(slot, value, __ATOMIC_SEQ_CST);
+			(void)mprotect(begin, span, prot);
+			return true;
+#elif defined(_WIN32)
+			DWORD old = 0;
+			if (!VirtualProtect(slot, sizeof(void*), PAGE_READWRITE, &old))
+			{
+				return false;
+			}
+			InterlockedExchangePointer(slot, value);
+			(void)VirtualProtect(slot, sizeof(void*), old, &old);
+			return true;
+#else
+			(void)slot;
+			(void)value;
+			return false;
+#endif
+		}
+
+		class VtableHooker : public Hooker
+		{
+		public:
+			bool CreateHook(void* target, void* detour, void** origin) override
+			{
+				if (target == nullptr || detour == nullptr || origin == nullptr)
+				{
+					return false;
+				}
+
+				auto** slot = static_cast<void**>(target);
+				std::lock_guard<std::mutex> guard{ mtx_ };
+				if (hooks_.find(slot) != hooks_.end())
+				{
+					return false;
+				}
+				Record record{};
+				record.original = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+				record.detour = detour;
+				hooks_.emplace(slot, record);
+
+				*origin = record.original;
+				return true;
+			}
+
+			bool EnableHook(void* target) override
+			{
+				return Switch(target, true);
+			}
+
+			bool DisableHook(void* target) override
+			{
+				return Switch(target, false);
+			}
+
+			bool RemoveHook(void* target) override
+			{
+				std::lock_guard<std::mutex> guard{ mtx_ };
+				auto it = hooks_.find(static_cast<void**>(target));
+				if (it == hooks_.end())
+				{
+					return false;
+				}
+				if (it->second.enabled && !WriteSlot(it->first, it->second.original))
+				{
+					return false;
+				}
+				hooks_.erase(it);
+				return true;
+			}
+
+		private:
+			struct Record
+			{
+				void* original = nullptr;
+				void* detour = nullptr;
+				bool enabled = false;
+			};
+
+			bool Switch(void* target, bool enable)
+			{
+				std::lock_guard<std::mutex> guard{ mtx_ };
+				auto it = hooks_.find(static_cast<void**>(target));
+				if (it == hooks_.end())
+				{
+					return false;
+				}
+				if (it->second.enabled == enable)
+				{
+					return true;
+				}
+				if (!WriteSlot(it->first, enable ? it->second.detour : it->second.original))
+				{
+					return false;
+				}
+				it->second.enabled = enable;
+				return true;
+			}
+
+			std::mutex mtx_{};
+			std::unordered_map<void**, Record> hooks_{};
+		};
+	}
+
+	Hooker& GetVtableHooker()
+	{
+		static VtableHooker instance{};
+		return instance;
+	}
+
+	void** FindVtable(const std::type_info& type)
+	{
+#ifdef CPPBM_VTABLE_ELF
+		static std::mutex mtx{};
+		static std::unordered_map<std::type_index, void**> cache{};
+
+		std::lock_guard<std::mutex> guard{ mtx };
+		auto it = cache.find(std::type_index(type));
+		if (it != cache.end())
+		{
+			return it->second;
+		}
+		void** vtable = ScanForVtable(&type);
+		// Misses are not cached: the class may live in a library loaded later.
+		if (vtable != nullptr)
+		{
+			cache.emplace(std::type_index(type), vtable);
+		}
+		return vtable;
+#else
+		(void)type;
+		return nullptr;
+#endif
+	}
+}
@@ -6,6 +6,8 @@
 #include <iostream>
 #include <numeric>
 #include <string>
+#include <typeindex>
+#include <unordered_map>
 #include <vector>
 #include <algorithm>
 
@@ -276,6 +278,112 @@ void RunCase(
     PrintStats("  Overhead(vs direct)", overhead_stats);
 }
 
+// DI key lookups, timed in batches (one clock read per kLookupBatch calls).
+namespace lookup_bench
+{
+    namespace some::deeply::nested_namespace
+    {
+        // Long mangled name, as real dependency types have.
+        template <int N>
+        struct ServiceDependency
+        {
+            int v = N;
+        };
+    }
+
+    template <int N>
+    using Dep = some::deeply::nested_namespace::ServiceDependency<N>;
+
+    constexpr int kLookupBatch = 1000;
+
+    template <typename F>
+    void RunLookupCase(const char* case_name, F&& fn, int warmup_iters, int measure_iters)
+    {
+        auto batch = [&]() {
+            std::size_t hits = 0;
+            for (int i = 0; i < kLookupBatch; ++i)
+            {
+                hits += fn() ? 1 : 0;
+            }
+            // GCC C++20 warns on compound assignment with volatile lvalue.
+            const std::size_t sink_snapshot = g_sink;
+            g_sink = sink_snapshot + hits;
+        };
+        const auto stats = ComputeStats(CollectSamples(batch, warmup_iters, measure_iters));
+        std::cout << case_name
+                  << " avg=" << std::fixed << std::setprecision(2) << stats.avg_ns / kLookupBatch << " ns/lookup"
+                  << " p50=" << static_cast<double>(stats.p50_ns) / kLookupBatch << " ns/lookup"
+                  << std::endl;
+    }
+
+    // Before: keys carried std::type_index, which hashes the mangled name on
+    // GCC/Clang. After: TypeKey, the address of one static per type.
+    void RunKeyLookups(int warmup_iters, int measure_iters)
+    {
+        std::unordered_map<std::type_index, int> by_type_index{};
+        std::unordered_map<depends::TypeKey, int, depends::TypeKeyHash> by_type_key{};
+        by_type_index.emplace(typeid(Dep<1>), 1);
+        by_type_index.emplace(typeid(Dep<2>), 2);
+        by_type_index.emplace(typeid(Dep<3>), 3);
+        by_type_key.emplace(depends::TypeKeyOf<Dep<1>>(), 1);
+        by_type_key.emplace(depends::TypeKeyOf<Dep<2>>(), 2);
+        by_type_key.emplace(depends::TypeKeyOf<Dep<3>>(), 3);
+
+        RunLookupCase(
+            "Lookup0 (before: std::type_index key)",
+            [&]() { return by_type_index.find(typeid(Dep<3>)) != by_type_index.end(); },
+            warmup_iters,
+            measure_iters);
+        RunLookupCase(
+            "Lookup1 (after: TypeKey key)",
+            [&]() { return by_type_key.find(depends::TypeKeyOf<Dep<3>>()) != by_type_key.end(); },
+            warmup_iters,
+            measure_iters);
+
+        // The lookups an @inject call makes, with TypeKey keys.
+        depends::ScopedInjectContext scope{};
+        depends::ContextScope root{};
+        depends::CacheOwnedDefault<Dep<1>>();
+        depends::CacheOwnedDefault<Dep<2>>();
+        depends::CacheOwnedDefault<Dep<3>>();
+        {
+            depends::ContextScope child1{};
+            depends::CacheOwnedDefault<Dep<4>>();
+            depends::ContextScope child2{};
+            depends::CacheOwnedDefault<Dep<5>>();
+            depends::ContextScope child3{};
+            depends::CacheOwnedDefault<Dep<6>>();
+
+            RunLookupCase(
+                "Lookup2 (context slot, local)",
+                []() { return depends::FindSlotInChain(depends::TypeKeyOf<Dep<6>>()) != nullptr; },
+                warmup_iters,
+                measure_iters);
+            RunLookupCase(
+                "Lookup3 (context slot, 3 levels up)",
+                []() { return depends::FindSlotInChain(depends::TypeKeyOf<Dep<3>>()) != nullptr; },
+                warmup_iters,
+                measure_iters);
+            RunLookupCase(
+                "Lookup4 (context slot, miss over 4 levels)",
+                []() { return depends::FindSlotInChain(depends::TypeKeyOf<Dep<9>>()) != nullptr; },
+                warmup_iters,
+                measure_iters);
+        }
+
+        RunLookupCase(
+            "Lookup5 (default-arg registry)",
+            []() {
+                return depends::GetDefaultArgRegistry().FindEntry(
+                    depends::TargetKeyOf<&benchmark_depends_plain>(),
+                    1,
+                    depends::TypeKeyOf<depends::DependsPtrValue<Config>>()) != nullptr;
+            },
+            warmup_iters,
+            measure_iters);
+    }
+}
+
 int main()
 {
     (void)ClearDependencies();
@@ -410,6 +518,9 @@ int main()
         kWarmupIters,
         kMeasureIters);
 
+    std::cout << "---- Key Lookups ----" << std::endl;
+    lookup_bench::RunKeyLookups(kWarmupIters, kMeasureIters);
+
     std::cout << "Sink: " << g_sink << std::endl;
     return 0;
 }
@@ -0,0 +1,236 @@
+// InjectContext slot storage: inline slots, the spill past kInlineSlots,
+// Clear() and reuse, and no heap traffic for a top-level call whose
+// dependencies are borrowed. Bindings are written by hand (what
+// decorator.py would generate), so no preprocess step is needed.
+#include <cppbm/depends.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include "expect.h"
+
+using namespace cpp::blackmagic;
+namespace dd = ::cpp::blackmagic::depends;
+
+namespace
+{
+    std::atomic<bool> g_counting{ false };
+    std::atomic<std::size_t> g_allocations{ 0 };
+
+    volatile int g_pad = 0;
+
+    // Shared by the scalar and array operator new replacements below.
+    void* CountedAlloc(std::size_t size)
+    {
+        if (g_counting.load(std::memory_order_relaxed))
+        {
+            g_allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (void* p = std::malloc(size == 0 ? 1 : size))
+        {
+            return p;
+        }
+        throw std::bad_alloc{};
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    return CountedAlloc(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return CountedAlloc(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+template <int N>
+struct Dep
+{
+    int value = N;
+};
+
+// ---- ContextSlotMap on its own -------------------------------------------
+
+template <int N>
+dd::SlotKey KeyOf()
+{
+    return dd::SlotKey{ dd::TypeKeyOf<Dep<N>>(), nullptr };
+}
+
+template <int N>
+dd::ContextSlot& Put(dd::ContextSlotMap& map, Dep<N>& dep)
+{
+    const dd::SlotKey key = KeyOf<N>();
+    dd::ContextSlot& slot = map.Upsert(key, dd::SlotKeyHash{}(key));
+    slot.obj = &dep;
+    return slot;
+}
+
+template <int N>
+void* Get(dd::ContextSlotMap& map)
+{
+    const dd::SlotKey key = KeyOf<N>();
+    dd::ContextSlot* slot = map.Find(key, dd::SlotKeyHash{}(key));
+    return slot != nullptr ? slot->obj : nullptr;
+}
+
+void TestSlotMap()
+{
+    static_assert(dd::ContextSlotMap::kInlineSlots == 4);
+
+    Dep<1> d1{};
+    Dep<2> d2{};
+    Dep<3> d3{};
+    Dep<4> d4{};
+    Dep<5> d5{};
+    Dep<6> d6{};
+
+    dd::ContextSlotMap map{};
+    Put(map, d1);
+    Put(map, d2);
+    Put(map, d3);
+    Put(map, d4);
+    Expect(map.Size() == 4 && Get<1>(map) == &d1 && Get<4>(map) == &d4, "inline slots");
+
+    // The fifth entry moves every slot to the heap table.
+    Put(map, d5);
+    Put(map, d6);
+    Expect(map.Size() == 6, "spilled size");
+    Expect(Get<1>(map) == &d1 && Get<2>(map) == &d2 && Get<3>(map) == &d3
+        && Get<4>(map) == &d4 && Get<5>(map) == &d5 && Get<6>(map) == &d6,
+        "every slot found after spilling, including the moved inline ones");
+    Expect(&Put(map, d3) == map.Find(KeyOf<3>(), dd::SlotKeyHash{}(KeyOf<3>())), "upsert of a spilled key finds it");
+    Expect(map.Size() == 6, "upsert of a spilled key adds nothing");
+
+    // Clear() keeps the spill table; the map starts inline again.
+    map.Clear();
+    Expect(map.Size() == 0 && Get<1>(map) == nullptr && Get<6>(map) == nullptr, "cleared");
+
+    g_allocations.store(0);
+    g_counting.store(true);
+    Put(map, d2);
+    Put(map, d5);
+    g_counting.store(false);
+    Expect(map.Size() == 2 && Get<2>(map) == &d2 && Get<5>(map) == &d5 && Get<1>(map) == nullptr,
+        "reused map holds only the new slots");
+    Expect(g_allocations.load() == 0, "reused map stores up to kInlineSlots inline again");
+
+    Put(map, d1);
+    Put(map, d3);
+    Put(map, d4);
+    Expect(map.Size() == 5 && Get<4>(map) == &d4 && Get<2>(map) == &d2, "reused map spills again");
+}
+
+// ---- Through @inject calls -----------------------------------------------
+
+Dep<1>& SharedOne()
+{
+    static Dep<1> dep{ 7 };
+    return dep;
+}
+
+Dep<2>& SharedTwo()
+{
+    static Dep<2> dep{ 8 };
+    return dep;
+}
+
+// noipa: callers must reach these symbols (the hooked ones), not clones
+// specialized for the constant placeholder arguments.
+[[gnu::noipa]] int Inner(Dep<1>* a = Depends(), Dep<6>* f = Depends())
+{
+    g_pad = g_pad + 1;
+    return a->value * 100 + f->value;
+}
+
+// Six dependencies: the call's context spills past kInlineSlots.
+[[gnu::noipa]] int Six(
+    Dep<1>* a = Depends(), Dep<2>* b = Depends(), Dep<3>* c = Depends(),
+    Dep<4>* d = Depends(), Dep<5>* e = Depends(), Dep<6>* f = Depends())
+{
+    g_pad = g_pad + 1;
+    a->value += 10;
+    f->value += 60;
+    // Inner resolves a and f from this (spilled) context through its parent link.
+    return a->value + b->value + c->value + d->value + e->value + f->value + Inner() * 1000;
+}
+
+[[gnu::noipa]] int Borrowed(Dep<1>* a = Depends(SharedOne), Dep<2>& b = Depends(SharedTwo))
+{
+    g_pad = g_pad + 1;
+    return a->value * 10 + b.value;
+}
+
+inline auto inner_binding = (inject).Bind<&Inner>(
+    dd::InjectArgMeta<0, Dep<1>*>([]() { return Depends(); }),
+    dd::InjectArgMeta<1, Dep<6>*>([]() { return Depends(); }));
+
+inline auto six_binding = (inject).Bind<&Six>(
+    dd::InjectArgMeta<0, Dep<1>*>([]() { return Depends(); }),
+    dd::InjectArgMeta<1, Dep<2>*>([]() { return Depends(); }),
+    dd::InjectArgMeta<2, Dep<3>*>([]() { return Depends(); }),
+    dd::InjectArgMeta<3, Dep<4>*>([]() { return Depends(); }),
+    dd::InjectArgMeta<4, Dep<5>*>([]() { return Depends(); }),
+    dd::InjectArgMeta<5, Dep<6>*>([]() { return Depends(); }));
+
+inline auto borrowed_binding = (inject).Bind<&Borrowed>(
+    dd::InjectArgMeta<0, Dep<1>*>([]() { return Depends(SharedOne); }),
+    dd::InjectArgMeta<1, Dep<2>&>([]() { return Depends(SharedTwo); }));
+
+void TestInjectCalls()
+{
+    // 11 + 2 + 3 + 4 + 5 + 66, plus Inner seeing the same a and f.
+    constexpr int kSix = 91 + (11 * 100 + 66) * 1000;
+    Expect(Six() == kSix, "spilled context resolves and serves a nested call");
+
+    // The reused top-level state was cleared: fresh dependencies, same result.
+    Expect(Six() == kSix, "second top-level call starts from a cleared context");
+    Expect(Inner() == 106, "a later call does not see the spilled slots");
+
+    int sum = Borrowed();
+    g_allocations.store(0);
+    g_counting.store(true);
+    for (int i = 0; i < 100; ++i)
+    {
+        sum += Borrowed();
+    }
+    g_counting.store(false);
+    Expect(sum == 101 * 78, "borrowed dependencies resolved");
+    Expect(g_allocations.load() == 0, "top-level call with two borrowed dependencies allocates nothing");
+    if (g_allocations.load() != 0)
+    {
+        std::cerr << "allocations over 100 calls: " << g_allocations.load() << std::endl;
+    }
+}
+
+int main()
+{
+    TestSlotMap();
+    TestInjectCalls();
+
+    return Finish("context ok");
+}
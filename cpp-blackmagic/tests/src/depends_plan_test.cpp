@@ -0,0 +1,103 @@
+// Compiled inject plans: steady-state calls run the plan without touching
+// the default-argument registry, and a re-Bind replaces the plan.
+// Bindings are written by hand (what decorator.py would generate), so no
+// preprocess step is needed.
+#include <cppbm/depends.h>
+
+#include <any>
+#include <iostream>
+
+#include "expect.h"
+
+using namespace cpp::blackmagic;
+namespace dd = ::cpp::blackmagic::depends;
+
+namespace
+{
+    int g_registry_probes = 0;
+    volatile int g_pad = 0;
+}
+
+struct Config
+{
+    int id = 0;
+};
+
+Config& FirstConfig()
+{
+    static Config cfg{ 1 };
+    return cfg;
+}
+
+Config& SecondConfig()
+{
+    static Config cfg{ 2 };
+    return cfg;
+}
+
+Config& RegistryConfig()
+{
+    static Config cfg{ 3 };
+    return cfg;
+}
+
+// noipa: callers must reach this symbol (the hooked one), not a clone
+// specialized for the constant placeholder argument.
+[[gnu::noipa]] int ReadId(Config* cfg = Depends(FirstConfig))
+{
+    g_pad = g_pad + 1;
+    return cfg != nullptr ? cfg->id : -1;
+}
+
+inline auto read_id_binding = (inject).Bind<&ReadId>(
+    dd::InjectArgMeta<0, Config*>([]() { return Depends(FirstConfig); }));
+
+// Replace the registry metadata of ReadId's parameter with an erased-only
+// entry that counts lookups; a call that reaches the registry (and its
+// std::any) shows up here and resolves to RegistryConfig.
+void ProbeRegistry()
+{
+    (void)dd::GetDefaultArgRegistry().Register(
+        dd::TargetKeyOf<&ReadId>(),
+        0,
+        dd::TypeKeyOf<dd::DependsPtrValue<Config>>(),
+        []() -> std::any
+        {
+            ++g_registry_probes;
+            dd::DependsPtrValue<Config> meta{};
+            meta.ptr = &RegistryConfig();
+            return std::any(meta);
+        });
+}
+
+int main()
+{
+    ProbeRegistry();
+    Expect(dd::FindInjectArgPlan<&ReadId, 0, Config*>() != nullptr, "Bind compiled a plan");
+
+    int sum = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        sum += ReadId();
+    }
+    Expect(sum == 100, "plan resolves the bound factory");
+    Expect(g_registry_probes == 0, "steady-state calls never look up the registry");
+
+    // Re-Bind with another factory: the plan follows the new metadata.
+    auto rebound = (inject).Bind<&ReadId>(
+        dd::InjectArgMeta<0, Config*>([]() { return Depends(SecondConfig); }));
+    ProbeRegistry();
+    Expect(ReadId() == 2, "re-Bind replaces the compiled plan");
+    Expect(g_registry_probes == 0, "re-bound calls still run the plan");
+
+    // Re-Bind with metadata that no longer compiles: the plan is cleared
+    // and calls fall back to the registry instead of the stale factory.
+    auto cleared = (inject).Bind<&ReadId>(
+        dd::InjectArgMeta<0, Config*>([]() { return Depends(static_cast<Config& (*)()>(nullptr)); }));
+    ProbeRegistry();
+    Expect(dd::FindInjectArgPlan<&ReadId, 0, Config*>() == nullptr, "re-Bind clears a plan it cannot compile");
+    Expect(ReadId() == 3, "cleared plan falls back to the registry");
+    Expect(g_registry_probes == 1, "fallback goes through the registry once per call");
+
+    return Finish("plan ok");
+}
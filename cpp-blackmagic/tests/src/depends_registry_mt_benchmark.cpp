@@ -0,0 +1,159 @@
+#include <cppbm/depends.h>
+
+#include <algorithm>
+#include <any>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace cpp::blackmagic;
+
+namespace
+{
+    // Prevent optimizer from removing benchmark work.
+    volatile std::uint64_t g_sink = 0;
+
+    // Distinct target keys, as TargetKeyOf<&Target>() would hand out.
+    constexpr std::size_t kTargets = 256;
+    constexpr std::size_t kParams = 4;
+    int g_targets[kTargets]{};
+
+    struct Config
+    {
+    };
+
+    struct Session
+    {
+    };
+}
+
+// Fill the registry the way a large program's static initializers would:
+// one entry per (target, parameter, metadata type).
+void PopulateRegistry()
+{
+    auto& registry = depends::GetDefaultArgRegistry();
+    for (std::size_t t = 0; t < kTargets; ++t)
+    {
+        for (std::size_t i = 0; i < kParams; ++i)
+        {
+            const depends::TypeKey type = (i % 2 == 0)
+                ? depends::TypeKeyOf<depends::DependsPtrValue<Config>>()
+                : depends::TypeKeyOf<depends::DependsPtrValue<Session>>();
+            (void)registry.Register(&g_targets[t], i, type, []() { return std::any{}; });
+        }
+    }
+}
+
+struct ScalingResult
+{
+    unsigned threads = 0;
+    double seconds = 0.0;
+    double finds_per_sec = 0.0;
+};
+
+ScalingResult RunThreads(unsigned threads, std::uint64_t finds_per_thread)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const auto& registry = depends::GetDefaultArgRegistry();
+
+    std::atomic<unsigned> ready{ 0 };
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> workers{};
+    workers.reserve(threads);
+
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]() {
+            ready.fetch_add(1, std::memory_order_acq_rel);
+            while (!go.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+
+            // Each thread walks the keys from its own offset, as unrelated
+            // @inject calls would.
+            std::uint64_t hits = 0;
+            std::size_t target = (t * 37) % kTargets;
+            std::size_t index = t % kParams;
+            for (std::uint64_t n = 0; n < finds_per_thread; ++n)
+            {
+                const depends::TypeKey type = (index % 2 == 0)
+                    ? depends::TypeKeyOf<depends::DependsPtrValue<Config>>()
+                    : depends::TypeKeyOf<depends::DependsPtrValue<Session>>();
+                hits += registry.Find(&g_targets[target], index, type) != nullptr;
+                target = (target + 1) % kTargets;
+                index = (index + 1) % kParams;
+            }
+            // GCC C++20 warns on compound assignment with volatile lvalue.
+            const std::uint64_t sink_snapshot = g_sink;
+            g_sink = sink_snapshot + hits;
+        });
+    }
+
+    while (ready.load(std::memory_order_acquire) != threads)
+    {
+        std::this_thread::yield();
+    }
+
+    const auto beg = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& w : workers)
+    {
+        w.join();
+    }
+    const auto end = Clock::now();
+
+    ScalingResult out{};
+    out.threads = threads;
+    out.seconds = std::chrono::duration<double>(end - beg).count();
+    out.finds_per_sec = static_cast<double>(finds_per_thread) * threads / out.seconds;
+    return out;
+}
+
+int main(int argc, char** argv)
+{
+    constexpr std::uint64_t kFindsPerThread = 10000000;
+
+    // Optional argv[1]: upper thread count (defaults to hardware concurrency).
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 1)
+    {
+        max_threads = std::max(1, std::atoi(argv[1]));
+    }
+
+    PopulateRegistry();
+    (void)RunThreads(1, 100000);
+
+    std::cout << "DefaultArgRegistry::Find throughput ("
+              << kTargets * kParams << " entries, " << kFindsPerThread << " finds/thread)" << std::endl;
+
+    double single = 0.0;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+    {
+        const auto r = RunThreads(threads, kFindsPerThread);
+        if (threads == 1)
+        {
+            single = r.finds_per_sec;
+        }
+        std::cout << "threads=" << std::setw(3) << r.threads
+                  << " time=" << std::fixed << std::setprecision(3) << r.seconds << " s"
+                  << " throughput=" << std::setprecision(1) << (r.finds_per_sec / 1e6) << " Mfinds/s"
+                  << " scaling=" << std::setprecision(2) << (single > 0.0 ? r.finds_per_sec / single : 0.0) << "x"
+                  << std::endl;
+
+        if (threads < max_threads && threads * 2 > max_threads)
+        {
+            threads = max_threads / 2;
+        }
+    }
+
+    std::cout << "Sink: " << g_sink << std::endl;
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Default-argument registry typed channel: InjectRegistry::Resolve calls the
+// typed factory, not the erased one, and both channels of one registration
+// produce the same metadata (pointer, ownership, cache flag, factory key).
+#include <cppbm/depends.h>
+
+#include <any>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "expect.h"
+
+using namespace cpp::blackmagic;
+namespace dd = ::cpp::blackmagic::depends;
+
+namespace
+{
+    int g_typed_calls = 0;
+    int g_erased_calls = 0;
+
+    // Registry target keys; nothing is hooked.
+    int g_probe_target = 0;
+    int g_borrowed_target = 0;
+    int g_owned_target = 0;
+    int g_placeholder_target = 0;
+
+    int TypedValue(void* state)
+    {
+        ++g_typed_calls;
+        return *static_cast<int*>(state);
+    }
+}
+
+struct Config
+{
+    int id = 0;
+};
+
+Config& SharedConfig()
+{
+    static Config cfg{ 7 };
+    return cfg;
+}
+
+Config* FreshConfig()
+{
+    return new Config{ 9 };
+}
+
+// Type keys only come from TypeKeyOf<T>(): a target or factory key passed
+// in the type position does not compile.
+static_assert(!std::is_constructible_v<dd::TypeKey, const void*>);
+static_assert(!std::is_invocable_v<decltype(&RemoveDependencyAt), const void*, const void*, const void*>);
+static_assert(std::is_invocable_v<decltype(&RemoveDependencyAt), const void*, const void*, dd::TypeKey>);
+static_assert(dd::TypeKeyOf<const Config&>() == dd::TypeKeyOf<Config>());
+static_assert(dd::TypeKeyOf<Config*>() != dd::TypeKeyOf<Config>());
+
+// Resolve one registration through both channels.
+template <typename U>
+std::pair<std::optional<U>, std::optional<U>> ResolveBoth(const void* target, std::size_t index)
+{
+    std::optional<U> typed = dd::InjectRegistry::Resolve<U>(target, index);
+    std::optional<U> erased{};
+    if (const dd::ErasedFactory* factory = dd::GetDefaultArgRegistry().Find(target, index, dd::TypeKeyOf<U>()))
+    {
+        erased = dd::AnyTo<U>((*factory)());
+    }
+    return { typed, erased };
+}
+
+template <typename Raw>
+bool SameMetadata(const dd::DependsPtrValue<Raw>& a, const dd::DependsPtrValue<Raw>& b, bool same_ptr)
+{
+    return a.owned == b.owned
+        && a.cached == b.cached
+        && a.factory == b.factory
+        && (!same_ptr || a.ptr == b.ptr);
+}
+
+int main()
+{
+    // Typed factory is preferred; Find() still serves the erased one.
+    auto state = std::make_shared<int>(42);
+    (void)dd::GetDefaultArgRegistry().RegisterTyped<int>(
+        &g_probe_target,
+        0,
+        &TypedValue,
+        state,
+        []() -> std::any
+        {
+            ++g_erased_calls;
+            return std::any(-1);
+        });
+
+    const std::optional<int> value = dd::InjectRegistry::Resolve<int>(&g_probe_target, 0);
+    Expect(value && *value == 42, "Resolve returns the typed factory's value");
+    Expect(g_typed_calls == 1 && g_erased_calls == 0, "Resolve calls the typed factory only");
+
+    const dd::ErasedFactory* erased = dd::GetDefaultArgRegistry().Find(&g_probe_target, 0, dd::TypeKeyOf<int>());
+    Expect(erased != nullptr && dd::AnyTo<int>((*erased)()) == -1, "Find returns the erased factory");
+    Expect(g_typed_calls == 1 && g_erased_calls == 1, "Find does not call the typed factory");
+
+    // Generated metadata, registered the way InjectArgMeta does it.
+    using Meta = dd::DependsPtrValue<Config>;
+
+    // Depends(factory) returning a reference: borrowed, same object.
+    (void)dd::InjectRegistry::RegisterAt<0>(&g_borrowed_target, []()
+        {
+            return dd::MakeDefaultArgMetadata<Config&>(Depends(SharedConfig));
+        });
+    {
+        const auto [typed, erased_meta] = ResolveBoth<Meta>(&g_borrowed_target, 0);
+        Expect(typed && erased_meta, "borrowed metadata resolves through both channels");
+        if (typed && erased_meta)
+        {
+            Expect(SameMetadata(*typed, *erased_meta, true), "borrowed metadata agrees across channels");
+            Expect(!typed->owned && typed->cached && typed->ptr == &SharedConfig(), "borrowed, cached, shared object");
+        }
+    }
+
+    // Depends(factory, false) returning a pointer: owned, a new object each time.
+    (void)dd::InjectRegistry::RegisterAt<0>(&g_owned_target, []()
+        {
+            return dd::MakeDefaultArgMetadata<Config*>(Depends(FreshConfig, false));
+        });
+    {
+        const auto [typed, erased_meta] = ResolveBoth<Meta>(&g_owned_target, 0);
+        Expect(typed && erased_meta, "owned metadata resolves through both channels");
+        if (typed && erased_meta)
+        {
+            Expect(SameMetadata(*typed, *erased_meta, false), "owned metadata agrees across channels");
+            Expect(typed->owned && !typed->cached, "owned, uncached");
+            Expect(typed->ptr != nullptr && erased_meta->ptr != nullptr && typed->ptr != erased_meta->ptr,
+                "each channel produced its own object");
+            delete typed->ptr;
+            delete erased_meta->ptr;
+        }
+    }
+
+    // Depends(): placeholder metadata, no factory.
+    (void)dd::InjectRegistry::RegisterAt<0>(&g_placeholder_target, []()
+        {
+            return dd::MakeDefaultArgMetadata<Config&>(Depends());
+        });
+    {
+        const auto [typed, erased_meta] = ResolveBoth<Meta>(&g_placeholder_target, 0);
+        Expect(typed && erased_meta, "placeholder metadata resolves through both channels");
+        if (typed && erased_meta)
+        {
+            Expect(SameMetadata(*typed, *erased_meta, true), "placeholder metadata agrees across channels");
+            Expect(typed->factory == nullptr, "placeholder has no factory key");
+        }
+    }
+
+    return Finish("registry ok");
+}
@@ -0,0 +1,41 @@
+// Check helpers shared by the cppbm-test-* executables: Expect() records a
+// failed condition and keeps going, main() ends with `return Finish(...)`.
+#ifndef __CPPBM_TESTS_EXPECT_H__
+#define __CPPBM_TESTS_EXPECT_H__
+
+#include <iostream>
+#include <string>
+
+inline int g_failures = 0;
+
+// Printed in parentheses after every failure when set (e.g. a call log).
+inline const std::string* g_failure_context = nullptr;
+
+inline void Expect(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        std::cerr << "FAILED: " << what;
+        if (g_failure_context != nullptr)
+        {
+            std::cerr << " (" << *g_failure_context << ")";
+        }
+        std::cerr << std::endl;
+        ++g_failures;
+    }
+}
+
+// Exit code of main(): 1 if any check failed, otherwise prints `parts` as
+// the success line and returns 0.
+template <typename... Parts>
+int Finish(const Parts&... parts)
+{
+    if (g_failures != 0)
+    {
+        return 1;
+    }
+    (std::cout << ... << parts) << std::endl;
+    return 0;
+}
+
+#endif // __CPPBM_TESTS_EXPECT_H__
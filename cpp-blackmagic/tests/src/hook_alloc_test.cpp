@@ -0,0 +1,259 @@
+#include <cppbm/decorator.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+
+using namespace cpp::blackmagic;
+
+// Global allocation counter:
+// every operator new in this process goes through here while counting is armed.
+namespace
+{
+    std::atomic<bool> g_counting{ false };
+    std::atomic<std::size_t> g_allocations{ 0 };
+
+    void* CountedAlloc(std::size_t size)
+    {
+        if (g_counting.load(std::memory_order_relaxed))
+        {
+            g_allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (void* p = std::malloc(size == 0 ? 1 : size))
+        {
+            return p;
+        }
+        throw std::bad_alloc{};
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    return CountedAlloc(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return CountedAlloc(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+    volatile std::int64_t g_sink = 0;
+    std::size_t g_misaligned = 0;
+}
+
+std::int64_t Accumulate(std::int64_t a, std::int64_t b)
+{
+    return a * 3 + b;
+}
+
+void Touch(std::int64_t v)
+{
+    // GCC C++20 warns on compound assignment with volatile lvalue.
+    const std::int64_t sink_snapshot = g_sink;
+    g_sink = sink_snapshot + v;
+}
+
+std::int64_t Spill(std::int64_t v)
+{
+    return v ^ 0x5a;
+}
+
+// Decorators with per-call context state.
+struct Frame
+{
+    std::int64_t depth = 0;
+};
+
+class AccumulateFrameDecorator : public FunctionDecorator<&Accumulate>
+{
+public:
+    std::size_t ContextSize() const override
+    {
+        return sizeof(Frame);
+    }
+
+    bool BeforeCall(hook::CallContext& ctx, std::int64_t& /*a*/, std::int64_t& /*b*/) override
+    {
+        auto* frame = ctx.As<Frame>();
+        if (frame == nullptr)
+        {
+            return false;
+        }
+        std::construct_at(frame, Frame{ 1 });
+        return true;
+    }
+
+    void AfterCall(hook::CallContext& ctx, std::int64_t& result) override
+    {
+        if (auto* frame = ctx.As<Frame>(); frame != nullptr)
+        {
+            result += frame->depth;
+            std::destroy_at(frame);
+        }
+    }
+};
+
+class TouchFrameDecorator : public FunctionDecorator<&Touch>
+{
+public:
+    std::size_t ContextSize() const override
+    {
+        return sizeof(Frame);
+    }
+
+    bool BeforeCall(hook::CallContext& ctx, std::int64_t& /*v*/) override
+    {
+        auto* frame = ctx.As<Frame>();
+        if (frame == nullptr)
+        {
+            return false;
+        }
+        std::construct_at(frame, Frame{ 1 });
+        return true;
+    }
+
+    void AfterCall(hook::CallContext& ctx) override
+    {
+        if (auto* frame = ctx.As<Frame>(); frame != nullptr)
+        {
+            std::destroy_at(frame);
+        }
+    }
+};
+
+// Over-aligned context larger than the stack arena limit:
+// exercises ContextAlign() and the per-thread spill arena.
+struct alignas(64) WideFrame
+{
+    unsigned char bytes[CPPBM_HOOK_STACK_ARENA_LIMIT + 64];
+};
+
+class SpillDecorator : public FunctionDecorator<&Spill>
+{
+public:
+    std::size_t ContextSize() const override
+    {
+        return sizeof(WideFrame);
+    }
+
+    std::size_t ContextAlign() const override
+    {
+        return alignof(WideFrame);
+    }
+
+    bool BeforeCall(hook::CallContext& ctx, std::int64_t& /*v*/) override
+    {
+        // As<> returns nullptr on a misaligned slot.
+        auto* frame = ctx.As<WideFrame>();
+        if (frame == nullptr)
+        {
+            ++g_misaligned;
+            return true;
+        }
+        frame->bytes[0] = 1;
+        return true;
+    }
+};
+
+// Observe-only decorator without context.
+template <auto Target>
+class ObserveDecorator;
+
+template <typename R, typename... Args, R(*Target)(Args...)>
+class ObserveDecorator<Target> : public FunctionDecorator<Target>
+{
+public:
+    bool BeforeCall(Args&... /*args*/) override
+    {
+        return true;
+    }
+};
+
+// Argument-rewriting decorator.
+class RewriteDecorator : public FunctionDecorator<&Accumulate>
+{
+public:
+    bool BeforeCall(std::int64_t& a, std::int64_t& /*b*/) override
+    {
+        a += 1;
+        return true;
+    }
+};
+
+// Deliberately several decorators per target to cover any chain length.
+inline AccumulateFrameDecorator accumulate_frame_a{};
+inline ObserveDecorator<&Accumulate> accumulate_observe{};
+inline RewriteDecorator accumulate_rewrite{};
+inline AccumulateFrameDecorator accumulate_frame_b{};
+inline TouchFrameDecorator touch_frame{};
+inline ObserveDecorator<&Touch> touch_observe{};
+inline SpillDecorator spill_context{};
+inline SpillDecorator spill_context_second{};
+
+int main()
+{
+    constexpr int kCalls = 10000;
+
+    std::int64_t(*volatile accumulate)(std::int64_t, std::int64_t) = &Accumulate;
+    void(*volatile touch)(std::int64_t) = &Touch;
+    std::int64_t(*volatile spill)(std::int64_t) = &Spill;
+
+    // Warm-up: hook install, lazy layout build, thread-local setup and the
+    // spill arena's first block may allocate.
+    std::int64_t acc = accumulate(1, 2);
+    touch(acc);
+    acc = spill(acc);
+
+    g_allocations.store(0, std::memory_order_relaxed);
+    g_counting.store(true, std::memory_order_relaxed);
+    for (int i = 0; i < kCalls; ++i)
+    {
+        acc = accumulate(acc & 0xffff, i);
+        touch(acc);
+        acc = spill(acc);
+    }
+    g_counting.store(false, std::memory_order_relaxed);
+
+    const std::size_t allocations = g_allocations.load(std::memory_order_relaxed);
+    std::cout << "hooked calls: " << (3 * kCalls)
+              << ", heap allocations: " << allocations
+              << ", sink: " << g_sink << std::endl;
+
+    if (allocations != 0)
+    {
+        std::cerr << "FAILED: decorated dispatch allocated on the heap." << std::endl;
+        return 1;
+    }
+    if (g_misaligned != 0)
+    {
+        std::cerr << "FAILED: over-aligned context slot was misaligned." << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <cppbm/decorator.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include "expect.h"
+
+using namespace cpp::blackmagic;
+
+namespace
+{
+    std::size_t g_before_calls = 0;
+
+    constexpr std::size_t kPrologueBytes = 16;
+
+    bool PrologueUnchanged(const void* fn, const unsigned char* saved)
+    {
+        return std::memcmp(saved, fn, kPrologueBytes) == 0;
+    }
+}
+
+// Called only through volatile pointers, so every call enters the patched
+// prologue.
+std::int64_t Alpha(std::int64_t v)
+{
+    return (v ^ 0x11) + 1;
+}
+
+std::int64_t Beta(std::int64_t v)
+{
+    return (v ^ 0x22) + 2;
+}
+
+std::int64_t Gamma(std::int64_t v)
+{
+    return (v ^ 0x33) + 3;
+}
+
+template <auto Target>
+class OffsetDecorator : public FunctionDecorator<Target>
+{
+public:
+    bool BeforeCall(std::int64_t& v) override
+    {
+        ++g_before_calls;
+        v += 1;
+        return true;
+    }
+};
+
+int main()
+{
+    std::int64_t(*volatile alpha)(std::int64_t) = &Alpha;
+    std::int64_t(*volatile beta)(std::int64_t) = &Beta;
+    std::int64_t(*volatile gamma)(std::int64_t) = &Gamma;
+
+    unsigned char saved_alpha[kPrologueBytes]{};
+    unsigned char saved_beta[kPrologueBytes]{};
+    unsigned char saved_gamma[kPrologueBytes]{};
+    std::memcpy(saved_alpha, reinterpret_cast<const void*>(&Alpha), kPrologueBytes);
+    std::memcpy(saved_beta, reinterpret_cast<const void*>(&Beta), kPrologueBytes);
+    std::memcpy(saved_gamma, reinterpret_cast<const void*>(&Gamma), kPrologueBytes);
+
+    BeginHookBatch();
+    OffsetDecorator<&Alpha> on_alpha{};
+    OffsetDecorator<&Beta> on_beta{};
+
+    // Nested batch: its commit must not apply the outer queue.
+    BeginHookBatch();
+    OffsetDecorator<&Gamma> on_gamma{};
+    Expect(CommitHookBatch(), "inner commit succeeds");
+
+    // Bypass requested while queued is honoured when the batch is applied.
+    Expect(SetDecoratorBypass<&Beta>(true), "bypass while queued succeeds");
+
+#ifdef CPPBM_TEST_BATCH_DEFERS_PATCH
+    Expect(PrologueUnchanged(reinterpret_cast<const void*>(&Alpha), saved_alpha), "alpha unpatched before commit");
+    Expect(PrologueUnchanged(reinterpret_cast<const void*>(&Gamma), saved_gamma), "gamma unpatched after inner commit");
+    Expect(alpha(1) == (1 ^ 0x11) + 1, "alpha runs its original before commit");
+    Expect(g_before_calls == 0, "no decorator runs before commit");
+#endif
+
+    Expect(CommitHookBatch(), "outer commit succeeds");
+    const std::size_t before_commit = g_before_calls;
+
+    Expect(!PrologueUnchanged(reinterpret_cast<const void*>(&Alpha), saved_alpha), "alpha patched after commit");
+    Expect(!PrologueUnchanged(reinterpret_cast<const void*>(&Gamma), saved_gamma), "gamma patched after commit");
+    Expect(PrologueUnchanged(reinterpret_cast<const void*>(&Beta), saved_beta), "bypassed beta left unpatched");
+
+    Expect(alpha(1) == (2 ^ 0x11) + 1, "alpha decorated after commit");
+    Expect(gamma(1) == (2 ^ 0x33) + 3, "gamma decorated after commit");
+    Expect(beta(1) == (1 ^ 0x22) + 2, "bypassed beta runs its original");
+    Expect(g_before_calls == before_commit + 2, "decorators run exactly on decorated calls");
+
+    Expect(SetDecoratorBypass<&Beta>(false), "resume after commit succeeds");
+    Expect(beta(1) == (2 ^ 0x22) + 2, "beta decorated after resume");
+
+    // Committing with no open batch is a no-op, as is an empty batch.
+    Expect(CommitHookBatch(), "unbalanced commit is harmless");
+    BeginHookBatch();
+    Expect(CommitHookBatch(), "empty batch commits");
+    Expect(InstallAll(), "InstallAll with nothing queued succeeds");
+
+    // Installs outside any batch take effect immediately again.
+    const std::size_t after_batch = g_before_calls;
+    OffsetDecorator<&Alpha> second_alpha{};
+    Expect(alpha(1) == (3 ^ 0x11) + 1, "second decorator on alpha runs immediately");
+    Expect(g_before_calls == after_batch + 2, "both alpha decorators run");
+
+    return Finish("hook batch ok, decorated calls: ", g_before_calls);
+}
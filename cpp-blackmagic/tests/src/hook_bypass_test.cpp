@@ -0,0 +1,74 @@
+#include <cppbm/decorator.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include "expect.h"
+
+using namespace cpp::blackmagic;
+
+namespace
+{
+    std::size_t g_before_calls = 0;
+}
+
+// Called only through a volatile pointer, so every call enters the patched
+// prologue.
+std::int64_t Scale(std::int64_t v)
+{
+    return (v ^ 0x2a) + 7;
+}
+
+class CountDecorator : public FunctionDecorator<&Scale>
+{
+public:
+    bool BeforeCall(std::int64_t& v) override
+    {
+        ++g_before_calls;
+        v += 1;
+        return true;
+    }
+};
+
+int main()
+{
+    std::int64_t(*volatile scale)(std::int64_t) = &Scale;
+
+    // Prologue bytes before any hook is installed.
+    unsigned char unhooked[16]{};
+    std::memcpy(unhooked, reinterpret_cast<const void*>(&Scale), sizeof(unhooked));
+
+    CountDecorator decorator{};
+    Expect(scale(1) == 47, "decorated call rewrites its argument");
+    Expect(g_before_calls == 1, "decorator runs while enabled");
+    Expect(std::memcmp(unhooked, reinterpret_cast<const void*>(&Scale), sizeof(unhooked)) != 0,
+        "installed hook patches the prologue");
+
+    Expect(SetDecoratorBypass<&Scale>(true), "bypass switch succeeds");
+    Expect(IsDecoratorBypassed<&Scale>(), "bypass state is reported");
+    Expect(std::memcmp(unhooked, reinterpret_cast<const void*>(&Scale), sizeof(unhooked)) == 0,
+        "bypass restores the original prologue");
+    for (int i = 0; i < 1000; ++i)
+    {
+        Expect(scale(i) == (i ^ 0x2a) + 7, "bypassed call runs the original");
+    }
+    Expect(g_before_calls == 1, "decorator is skipped while bypassed");
+
+    Expect(SetDecoratorBypass<&Scale>(false), "resume switch succeeds");
+    Expect(!IsDecoratorBypassed<&Scale>(), "resume state is reported");
+    Expect(scale(1) == 47, "resumed call is decorated again");
+    Expect(g_before_calls == 2, "decorator runs after resume");
+
+    // Toggling repeatedly keeps the trampoline valid.
+    for (int i = 0; i < 100; ++i)
+    {
+        Expect(SetDecoratorBypass<&Scale>(i % 2 == 0), "repeated toggle succeeds");
+        (void)scale(i);
+    }
+    Expect(SetDecoratorBypass<&Scale>(false), "final resume succeeds");
+    Expect(g_before_calls == 52, "decorator runs exactly on enabled toggles");
+
+    return Finish("bypass toggle ok, decorated calls: ", g_before_calls);
+}
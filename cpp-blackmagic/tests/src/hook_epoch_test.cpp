@@ -0,0 +1,207 @@
+// Snapshot publication around an in-flight call: registering a decorator
+// never waits for calls already running, unregistering one does. Parked
+// snapshots are freed as soon as a registration finds no call in flight.
+#include <cppbm/decorator.h>
+#include <cppbm/internal/utils/epoch.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "expect.h"
+
+using namespace cpp::blackmagic;
+
+namespace
+{
+    std::atomic<bool> g_entered{ false };
+    std::atomic<bool> g_release{ false };
+    std::atomic<int> g_outer_calls{ 0 };
+    std::atomic<int> g_late_calls{ 0 };
+    int g_freed = 0;
+
+    void CountFree(void* /*ptr*/)
+    {
+        ++g_freed;
+    }
+
+    template <typename F>
+    bool FinishesWithin(std::future<F>& pending, std::chrono::milliseconds timeout)
+    {
+        return pending.wait_for(timeout) == std::future_status::ready;
+    }
+}
+
+// Blocks until released; the hooked call holds its read section meanwhile.
+std::int64_t Slow(std::int64_t v)
+{
+    g_entered.store(true);
+    while (!g_release.load())
+    {
+        std::this_thread::yield();
+    }
+    return v + 1;
+}
+
+std::int64_t Busy(std::int64_t v)
+{
+    return v ^ 0x5a;
+}
+
+class OuterDecorator : public FunctionDecorator<&Slow>
+{
+public:
+    bool BeforeCall(std::int64_t& /*v*/) override
+    {
+        g_outer_calls.fetch_add(1);
+        return true;
+    }
+};
+
+inline OuterDecorator outer_decorator{};
+
+class LateDecorator : public FunctionDecorator<&Slow>
+{
+public:
+    bool BeforeCall(std::int64_t& /*v*/) override
+    {
+        g_late_calls.fetch_add(1);
+        return true;
+    }
+};
+
+template <auto Target>
+class CountDecorator : public FunctionDecorator<Target>
+{
+public:
+    explicit CountDecorator(std::atomic<std::int64_t>& calls)
+        : calls_(&calls)
+    {
+    }
+
+    bool BeforeCall(std::int64_t& /*v*/) override
+    {
+        calls_->fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    std::atomic<std::int64_t>* calls_ = nullptr;
+};
+
+inline std::atomic<std::int64_t> g_busy_base_calls{ 0 };
+inline CountDecorator<&Busy> busy_base_decorator{ g_busy_base_calls };
+
+// Defer() never waits, and frees what is parked once no reader is open.
+void TestDeferReclaim()
+{
+    utils::EpochDomain domain{};
+    int items[4]{};
+
+    domain.Defer(&items[0], &CountFree);
+    Expect(g_freed == 1, "idle domain frees a deferred pointer at once");
+
+    std::atomic<bool> entered{ false };
+    std::atomic<bool> leave{ false };
+    std::thread reader([&]()
+        {
+            utils::EpochDomain::ReadGuard guard{ domain };
+            entered.store(true);
+            while (!leave.load())
+            {
+                std::this_thread::yield();
+            }
+        });
+    while (!entered.load())
+    {
+        std::this_thread::yield();
+    }
+    domain.Defer(&items[1], &CountFree);
+    domain.Defer(&items[2], &CountFree);
+    Expect(g_freed == 1, "open read section keeps deferred pointers parked");
+
+    leave.store(true);
+    reader.join();
+    domain.Defer(&items[3], &CountFree);
+    Expect(g_freed == 4, "next idle Defer frees everything parked so far");
+}
+
+int main()
+{
+    using namespace std::chrono_literals;
+
+    TestDeferReclaim();
+
+    std::int64_t(*volatile slow)(std::int64_t) = &Slow;
+    std::thread caller([&]() { Expect(slow(1) == 2, "blocked call completes"); });
+    while (!g_entered.load())
+    {
+        std::this_thread::yield();
+    }
+
+    // Register while the call is still inside Slow.
+    std::optional<LateDecorator> late{};
+    auto registered = std::async(std::launch::async, [&]() { late.emplace(); });
+    const bool register_returned = FinishesWithin(registered, 2s);
+    Expect(register_returned, "registration returns while a call is in flight");
+
+    // Unregister must wait for that call.
+    std::future<void> unregistered{};
+    if (register_returned)
+    {
+        unregistered = std::async(std::launch::async, [&]() { late.reset(); });
+        Expect(!FinishesWithin(unregistered, 100ms), "unregistration waits for the in-flight call");
+    }
+
+    g_release.store(true);
+    caller.join();
+    registered.wait();
+    if (unregistered.valid())
+    {
+        Expect(FinishesWithin(unregistered, 2s), "unregistration returns once the call left");
+    }
+    Expect(g_outer_calls.load() == 1, "in-flight call ran its own snapshot");
+    Expect(g_late_calls.load() == 0, "late decorator never saw the in-flight call");
+
+    // Many readers on one target, spread over counter stripes, while
+    // decorators are registered and unregistered under them.
+    constexpr int kThreads = 4;
+    constexpr int kSwitches = 50;
+    std::atomic<bool> stop{ false };
+    std::atomic<std::int64_t> bad{ 0 };
+    std::vector<std::thread> workers{};
+    for (int t = 0; t < kThreads; ++t)
+    {
+        workers.emplace_back([&]()
+            {
+                std::int64_t(*volatile busy)(std::int64_t) = &Busy;
+                for (std::int64_t v = 0; !stop.load(std::memory_order_relaxed); ++v)
+                {
+                    if (busy(v) != (v ^ 0x5a))
+                    {
+                        bad.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+    }
+    std::atomic<std::int64_t> extra_calls{ 0 };
+    for (int i = 0; i < kSwitches; ++i)
+    {
+        CountDecorator<&Busy> extra{ extra_calls };
+        std::this_thread::yield();
+    }
+    stop.store(true);
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    Expect(bad.load() == 0, "results unchanged while decorators come and go");
+    Expect(g_busy_base_calls.load() > 0, "base decorator ran");
+
+    return Finish("epoch ok: ", g_busy_base_calls.load(), " calls, ", extra_calls.load(), " through transient decorators");
+}
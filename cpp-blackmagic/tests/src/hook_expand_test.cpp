@@ -0,0 +1,132 @@
+// Source expansion: the targets below are written the way decorator.py
+// --expand rewrites a decorated definition (the original renamed on its own
+// lines, the forwarding wrapper appended after it, the Bind() sentence ahead
+// of the bindings), so the test builds without the preprocess step.
+#include <cppbm/decorator.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include "expect.h"
+
+using namespace cpp::blackmagic;
+
+namespace
+{
+    std::size_t g_before_calls = 0;
+}
+
+namespace expand
+{
+    // Source: std::int64_t Mix(std::int64_t v, std::int64_t k = 9) { ... }
+    std::int64_t Mix(std::int64_t v, std::int64_t k = 9); static std::int64_t __cppbm_orig_Mix(std::int64_t v, std::int64_t k = 9)
+    {
+        return (v ^ 0x5a) + k;
+    } std::int64_t Mix(std::int64_t v, std::int64_t k ) { return ::cpp::blackmagic::hook::Expanded<&Mix, &__cppbm_orig_Mix>::Call(static_cast<decltype(v)&&>(v), static_cast<decltype(k)&&>(k)); }
+
+    // Recursion goes back through the wrapper, like through a patched target.
+    std::uint64_t Fact(std::uint64_t n); static std::uint64_t __cppbm_orig_Fact(std::uint64_t n)
+    {
+        return n <= 1 ? 1 : n * Fact(n - 1);
+    } std::uint64_t Fact(std::uint64_t n) { return ::cpp::blackmagic::hook::Expanded<&Fact, &__cppbm_orig_Fact>::Call(static_cast<decltype(n)&&>(n)); }
+
+    std::int64_t Late(std::int64_t v); static std::int64_t __cppbm_orig_Late(std::int64_t v)
+    {
+        return v * 3;
+    } std::int64_t Late(std::int64_t v) { return ::cpp::blackmagic::hook::Expanded<&Late, &__cppbm_orig_Late>::Call(static_cast<decltype(v)&&>(v)); }
+}
+
+class MixDecorator : public FunctionDecorator<&expand::Mix>
+{
+public:
+    bool BeforeCall(std::int64_t& v, std::int64_t&) override
+    {
+        ++g_before_calls;
+        v += 1;
+        return true;
+    }
+
+    void AfterCall(std::int64_t& result) override
+    {
+        // Original() is the renamed definition, never the wrapper.
+        Expect(CallOriginal(0, 0) == 0x5a, "CallOriginal reaches the renamed original");
+        result += 1000;
+    }
+};
+
+class CountDecorator : public FunctionDecorator<&expand::Fact>
+{
+public:
+    bool BeforeCall(std::uint64_t&) override
+    {
+        ++g_before_calls;
+        return true;
+    }
+};
+
+class LateDecorator : public FunctionDecorator<&expand::Late>
+{
+public:
+    bool BeforeCall(std::int64_t& v) override
+    {
+        ++g_before_calls;
+        v += 1;
+        return true;
+    }
+};
+
+// Registered before Late's Bind() below, as a decorator from another
+// translation unit's static initializer could be: the backend patches the
+// wrapper first, and Bind() must take the target over from it.
+static LateDecorator g_early_late{};
+
+// Generated ahead of the decorator bindings.
+namespace expand
+{
+[[maybe_unused]] static const bool __cppbm_expand_Mix_0_0 = ::cpp::blackmagic::hook::Expanded<&Mix, &__cppbm_orig_Mix>::Bind();
+[[maybe_unused]] static const bool __cppbm_expand_Fact_0_1 = ::cpp::blackmagic::hook::Expanded<&Fact, &__cppbm_orig_Fact>::Bind();
+[[maybe_unused]] static const bool __cppbm_expand_Late_0_2 = ::cpp::blackmagic::hook::Expanded<&Late, &__cppbm_orig_Late>::Bind();
+}
+
+int main()
+{
+    Expect(expand::__cppbm_expand_Mix_0_0 && expand::__cppbm_expand_Fact_0_1, "bound");
+    Expect(expand::__cppbm_expand_Late_0_2, "backend hook taken over");
+    Expect(GetDecoratorState<&expand::Mix>() == HookPipelineState::Installed, "installed without a backend");
+
+#ifdef CPPBM_TEST_EXPAND_BACKEND_PATCHES
+    std::int64_t(*volatile late)(std::int64_t) = &expand::Late;
+    Expect(late(2) == 9, "taken-over target decorated once");
+    Expect(g_before_calls == 1, "taken-over decorator ran once");
+    g_before_calls = 0;
+#endif
+
+    unsigned char entry[16]{};
+    std::memcpy(entry, reinterpret_cast<const void*>(&expand::Mix), sizeof(entry));
+
+    Expect(expand::Mix(1) == ((1 ^ 0x5a) + 9), "undecorated call");
+    {
+        MixDecorator decorator{};
+        Expect(expand::Mix(1) == ((2 ^ 0x5a) + 9) + 1000, "decorated call, default argument kept");
+        Expect(expand::Mix(1, 4) == ((2 ^ 0x5a) + 4) + 1000, "decorated call, explicit argument");
+        Expect(g_before_calls == 2, "decorator ran");
+
+        Expect(SetDecoratorBypass<&expand::Mix>(true), "bypass succeeds");
+        Expect(expand::Mix(1) == ((1 ^ 0x5a) + 9), "bypassed call runs the original");
+        Expect(SetDecoratorBypass<&expand::Mix>(false), "resume succeeds");
+        Expect(g_before_calls == 2, "bypassed call skipped the decorator");
+    }
+    Expect(std::memcmp(entry, reinterpret_cast<const void*>(&expand::Mix), sizeof(entry)) == 0,
+        "no code was patched");
+
+    g_before_calls = 0;
+    {
+        CountDecorator decorator{};
+        Expect(expand::Fact(5) == 120, "recursive result");
+        Expect(g_before_calls == 5, "every recursion level decorated");
+    }
+
+    return Finish("expand ok");
+}
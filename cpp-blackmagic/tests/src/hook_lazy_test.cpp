@@ -0,0 +1,109 @@
+#include <cppbm/decorator.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include "expect.h"
+
+using namespace cpp::blackmagic;
+
+namespace
+{
+    std::size_t g_before_calls = 0;
+
+    constexpr std::size_t kPrologueBytes = 16;
+
+    bool PrologueUnchanged(const void* fn, const unsigned char* saved)
+    {
+        return std::memcmp(saved, fn, kPrologueBytes) == 0;
+    }
+}
+
+// Called only through volatile pointers, so every call enters the patched
+// prologue.
+std::int64_t Rare(std::int64_t v)
+{
+    return (v ^ 0x44) + 4;
+}
+
+std::int64_t Cold(std::int64_t v)
+{
+    return (v ^ 0x55) + 5;
+}
+
+std::int64_t Late(std::int64_t v)
+{
+    return (v ^ 0x66) + 6;
+}
+
+template <auto Target>
+class OffsetDecorator : public FunctionDecorator<Target>
+{
+public:
+    bool BeforeCall(std::int64_t& v) override
+    {
+        ++g_before_calls;
+        v += 1;
+        return true;
+    }
+};
+
+int main()
+{
+    std::int64_t(*volatile rare)(std::int64_t) = &Rare;
+    std::int64_t(*volatile cold)(std::int64_t) = &Cold;
+    std::int64_t(*volatile late)(std::int64_t) = &Late;
+
+    unsigned char saved_rare[kPrologueBytes]{};
+    unsigned char saved_cold[kPrologueBytes]{};
+    std::memcpy(saved_rare, reinterpret_cast<const void*>(&Rare), kPrologueBytes);
+    std::memcpy(saved_cold, reinterpret_cast<const void*>(&Cold), kPrologueBytes);
+
+    SetHookInstallMode(HookInstallMode::Lazy);
+    Expect(GetDecoratorState<&Rare>() == HookPipelineState::Idle, "rare idle before registration");
+
+    OffsetDecorator<&Rare> on_rare{};
+    OffsetDecorator<&Cold> on_cold{};
+    Expect(GetDecoratorState<&Rare>() == HookPipelineState::Registered, "rare only registered");
+    Expect(PrologueUnchanged(reinterpret_cast<const void*>(&Rare), saved_rare), "rare unpatched before activation");
+    Expect(rare(1) == (1 ^ 0x44) + 4, "rare runs natively before activation");
+    Expect(g_before_calls == 0, "no decorator runs before activation");
+
+    Expect(ActivateDecorator<&Rare>(), "activation succeeds");
+    Expect(ActivateDecorator<&Rare>(), "activation is idempotent");
+    Expect(GetDecoratorState<&Rare>() == HookPipelineState::Installed, "rare installed after activation");
+    Expect(!PrologueUnchanged(reinterpret_cast<const void*>(&Rare), saved_rare), "rare patched after activation");
+    Expect(rare(1) == (2 ^ 0x44) + 4, "rare decorated after activation");
+    Expect(g_before_calls == 1, "decorator runs once activated");
+
+    // A second decorator on an activated target installs (and runs) at once.
+    {
+        OffsetDecorator<&Rare> again{};
+        Expect(rare(1) == (3 ^ 0x44) + 4, "later registration on activated target is live");
+    }
+    Expect(g_before_calls == 3, "both rare decorators ran");
+
+    Expect(SetDecoratorBypass<&Rare>(true), "bypass succeeds");
+    Expect(GetDecoratorState<&Rare>() == HookPipelineState::Bypassed, "rare reported bypassed");
+    Expect(SetDecoratorBypass<&Rare>(false), "resume succeeds");
+    Expect(GetDecoratorState<&Rare>() == HookPipelineState::Installed, "rare installed after resume");
+
+    // Never activated: stays native.
+    Expect(GetDecoratorState<&Cold>() == HookPipelineState::Registered, "cold still only registered");
+    Expect(PrologueUnchanged(reinterpret_cast<const void*>(&Cold), saved_cold), "cold never patched");
+    Expect(cold(1) == (1 ^ 0x55) + 5, "cold runs natively");
+
+    // Activated before any decorator exists: the first registration installs.
+    Expect(ActivateDecorator<&Late>(), "activation with nothing registered succeeds");
+    Expect(GetDecoratorState<&Late>() == HookPipelineState::Idle, "late idle until registration");
+    OffsetDecorator<&Late> on_late{};
+    Expect(GetDecoratorState<&Late>() == HookPipelineState::Installed, "late installed on registration");
+    Expect(late(1) == (2 ^ 0x66) + 6, "late decorated");
+
+    SetHookInstallMode(HookInstallMode::Eager);
+    Expect(GetHookInstallMode() == HookInstallMode::Eager, "eager mode restored");
+
+    return Finish("lazy install ok, decorated calls: ", g_before_calls);
+}
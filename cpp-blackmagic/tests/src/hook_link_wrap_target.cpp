@@ -0,0 +1,19 @@
+// Translation unit defining the target of cppbm-test-hook-link-wrap.
+// The trailing CPPBM_LINK_WRAP line is what decorator.py --link-wrap appends
+// after a decorated free-function definition.
+#include <cstdint>
+
+#include <cppbm/internal/hook/link_wrap.h>
+
+namespace linkwrap
+{
+    std::int64_t Mix(std::int64_t v)
+    {
+        return (v ^ 0x5a) + 9;
+    }
+}
+
+namespace linkwrap
+{
+CPPBM_LINK_WRAP(__cppbm_link_Mix_0_0, (&linkwrap::Mix))
+}
@@ -0,0 +1,68 @@
+#include <cppbm/decorator.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include "expect.h"
+
+using namespace cpp::blackmagic;
+
+namespace linkwrap
+{
+    std::int64_t Mix(std::int64_t v);
+}
+
+namespace
+{
+    std::size_t g_before_calls = 0;
+
+    std::int64_t Expected(std::int64_t v)
+    {
+        return (v ^ 0x5a) + 9;
+    }
+}
+
+class CountDecorator : public FunctionDecorator<&linkwrap::Mix>
+{
+public:
+    bool BeforeCall(std::int64_t& v) override
+    {
+        ++g_before_calls;
+        v += 1;
+        return true;
+    }
+};
+
+int main()
+{
+    // Installed by the link-time glue before main; no backend involved.
+    Expect(GetDecoratorState<&linkwrap::Mix>() == HookPipelineState::Installed, "linked before main");
+
+    // Calls from this object go through __wrap_ without any decorator.
+    Expect(linkwrap::Mix(1) == Expected(1), "undecorated call reaches the original");
+
+    // &linkwrap::Mix from this object is the wrapper itself.
+    unsigned char entry[8]{};
+    std::memcpy(entry, reinterpret_cast<const void*>(&linkwrap::Mix), sizeof(entry));
+
+    {
+        CountDecorator decorator{};
+        Expect(linkwrap::Mix(1) == Expected(2), "decorated call");
+        Expect(g_before_calls == 1, "decorator ran");
+
+        Expect(SetDecoratorBypass<&linkwrap::Mix>(true), "bypass succeeds");
+        Expect(GetDecoratorState<&linkwrap::Mix>() == HookPipelineState::Bypassed, "bypass reported");
+        Expect(linkwrap::Mix(1) == Expected(1), "bypassed call runs the original");
+        Expect(SetDecoratorBypass<&linkwrap::Mix>(false), "resume succeeds");
+        Expect(linkwrap::Mix(1) == Expected(2), "resumed call is decorated");
+        Expect(g_before_calls == 2, "decorator ran after resume");
+    }
+
+    Expect(std::memcmp(entry, reinterpret_cast<const void*>(&linkwrap::Mix), sizeof(entry)) == 0,
+        "no code was patched");
+    Expect(linkwrap::Mix(3) == Expected(3), "unregistered decorator no longer runs");
+
+    return Finish("link wrap ok, decorated calls: ", g_before_calls);
+}
@@ -0,0 +1,152 @@
+#include <cppbm/decorator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace cpp::blackmagic;
+
+namespace
+{
+    // Prevent optimizer from removing benchmark work.
+    volatile std::uint64_t g_sink = 0;
+
+    thread_local std::uint64_t t_before_calls = 0;
+}
+
+// Small amount of real work so the hooked body is not free.
+std::uint64_t HotHandler(std::uint64_t seed)
+{
+    std::uint64_t x = seed;
+    for (int i = 0; i < 32; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+    return x;
+}
+
+// Observe-only decorator that touches thread-local state only,
+// so any cross-thread slowdown comes from the hook pipeline itself.
+class CountingDecorator : public FunctionDecorator<&HotHandler>
+{
+public:
+    bool BeforeCall(std::uint64_t& /*seed*/) override
+    {
+        ++t_before_calls;
+        return true;
+    }
+
+    void AfterCall(std::uint64_t& result) override
+    {
+        result += 1;
+    }
+};
+
+inline CountingDecorator counting_decorator{};
+
+struct ScalingResult
+{
+    unsigned threads = 0;
+    double seconds = 0.0;
+    double calls_per_sec = 0.0;
+};
+
+ScalingResult RunThreads(unsigned threads, std::uint64_t calls_per_thread)
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Call through a volatile pointer so the compiler cannot bypass the hooked entry.
+    std::uint64_t(*volatile fn)(std::uint64_t) = &HotHandler;
+
+    std::atomic<unsigned> ready{ 0 };
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> workers{};
+    workers.reserve(threads);
+
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]() {
+            ready.fetch_add(1, std::memory_order_acq_rel);
+            while (!go.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+
+            std::uint64_t acc = t + 1;
+            for (std::uint64_t i = 0; i < calls_per_thread; ++i)
+            {
+                acc = fn(acc);
+            }
+            // GCC C++20 warns on compound assignment with volatile lvalue.
+            const std::uint64_t sink_snapshot = g_sink;
+            g_sink = sink_snapshot + acc + t_before_calls;
+        });
+    }
+
+    while (ready.load(std::memory_order_acquire) != threads)
+    {
+        std::this_thread::yield();
+    }
+
+    const auto beg = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& w : workers)
+    {
+        w.join();
+    }
+    const auto end = Clock::now();
+
+    ScalingResult out{};
+    out.threads = threads;
+    out.seconds = std::chrono::duration<double>(end - beg).count();
+    out.calls_per_sec = static_cast<double>(calls_per_thread) * threads / out.seconds;
+    return out;
+}
+
+int main(int argc, char** argv)
+{
+    constexpr std::uint64_t kCallsPerThread = 2000000;
+
+    // Optional argv[1]: upper thread count (defaults to hardware concurrency).
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 1)
+    {
+        max_threads = std::max(1, std::atoi(argv[1]));
+    }
+
+    // Warm up hook installation and lazy layout build.
+    (void)RunThreads(1, 10000);
+
+    std::cout << "Hooked call throughput (" << kCallsPerThread << " calls/thread)" << std::endl;
+
+    double single = 0.0;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+    {
+        const auto r = RunThreads(threads, kCallsPerThread);
+        if (threads == 1)
+        {
+            single = r.calls_per_sec;
+        }
+        std::cout << "threads=" << std::setw(3) << r.threads
+                  << " time=" << std::fixed << std::setprecision(3) << r.seconds << " s"
+                  << " throughput=" << std::setprecision(1) << (r.calls_per_sec / 1e6) << " Mcalls/s"
+                  << " scaling=" << std::setprecision(2) << (single > 0.0 ? r.calls_per_sec / single : 0.0) << "x"
+                  << std::endl;
+
+        if (threads < max_threads && threads * 2 > max_threads)
+        {
+            threads = max_threads / 2;
+        }
+    }
+
+    std::cout << "Sink: " << g_sink << std::endl;
+    return 0;
+}
@@ -0,0 +1,81 @@
+// Profiler symbols: generated trampolines named after their targets in
+// /tmp/perf-<pid>.map and in a jitdump.
+#include <cppbm/decorator.h>
+#include <cppbm/internal/hook/perf_map.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+
+#include "expect.h"
+
+using namespace cpp::blackmagic;
+
+namespace
+{
+    std::string ReadFile(const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+}
+
+// Exported (ENABLE_EXPORTS), so the regions carry their demangled names.
+std::int64_t Early(std::int64_t v)
+{
+    return (v ^ 0x21) + 1;
+}
+
+std::int64_t Late(std::int64_t v)
+{
+    return (v ^ 0x42) + 2;
+}
+
+template <auto Target>
+class CountDecorator : public FunctionDecorator<Target>
+{
+public:
+    bool BeforeCall(std::int64_t&) override
+    {
+        return true;
+    }
+};
+
+int main()
+{
+    const std::string map_path = "/tmp/perf-" + std::to_string(getpid()) + ".map";
+    const std::string dump_path = "/tmp/jit-" + std::to_string(getpid()) + ".dump";
+    unsetenv("JITDUMP_DIR");
+    hook::SetPerfMapMode(hook::PerfMapMode::Off);
+
+    CountDecorator<&Early> early{};
+    Expect(ReadFile(map_path).empty(), "nothing written while off");
+
+    // Switching on writes the regions generated before.
+    hook::SetPerfMapMode(hook::PerfMapMode::Map);
+    Expect(ReadFile(map_path).find(" cppbm::trampoline::Early(long)\n") != std::string::npos, "earlier trampoline named");
+
+    CountDecorator<&Late> late{};
+    const std::string map = ReadFile(map_path);
+    Expect(map.find(" cppbm::trampoline::Late(long)\n") != std::string::npos, "new trampoline named");
+    Expect(map.find("cppbm::trampoline::Early(long)") == map.rfind("cppbm::trampoline::Early(long)"), "no duplicate lines");
+
+    hook::SetPerfMapMode(hook::PerfMapMode::JitDump);
+    const std::string dump = ReadFile(dump_path);
+    Expect(dump.size() > 40 && dump.compare(0, 4, "DTiJ") == 0, "jitdump header");
+    Expect(dump.find("cppbm::trampoline::Late(long)") != std::string::npos, "jitdump code load");
+
+    std::int64_t(*volatile early_fn)(std::int64_t) = &Early;
+    Expect(early_fn(3) == ((3 ^ 0x21) + 1), "hooked call still runs the original");
+
+    hook::SetPerfMapMode(hook::PerfMapMode::Off);
+    std::remove(map_path.c_str());
+    std::remove(dump_path.c_str());
+
+    return Finish("perf map ok");
+}
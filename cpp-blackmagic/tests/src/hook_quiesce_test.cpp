@@ -0,0 +1,118 @@
+// Stop-the-world live patching: a hooked target switched on and off while
+// worker threads keep calling it; every switch parks the workers first.
+#include <cppbm/decorator.h>
+
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <pthread.h>
+#include <thread>
+#include <vector>
+
+#include "expect.h"
+
+using namespace cpp::blackmagic;
+
+std::int64_t Hot(std::int64_t v)
+{
+    return v * 2 + 1;
+}
+
+template <auto Target>
+class ShiftDecorator : public FunctionDecorator<Target>
+{
+public:
+    bool BeforeCall(std::int64_t& v) override
+    {
+        v += 1;
+        return true;
+    }
+};
+
+int main()
+{
+    constexpr std::size_t kWorkers = 4;
+    constexpr int kSwitches = 50;
+
+    SetLivePatchMode(LivePatchMode::StopTheWorld);
+    // Dobby writes a new hook's first patch itself (see quiesce.h), so the
+    // hook goes in before the workers start.
+    ShiftDecorator<&Hot> decorator{};
+
+    std::atomic<bool> stop{ false };
+    std::atomic<std::size_t> bad{ 0 };
+    std::atomic<std::size_t> calls{ 0 };
+    std::vector<std::thread> workers{};
+    for (std::size_t i = 0; i < kWorkers; ++i)
+    {
+        workers.emplace_back([&]()
+            {
+                std::int64_t(*volatile hot)(std::int64_t) = &Hot;
+                for (std::int64_t v = 0; !stop.load(std::memory_order_relaxed); ++v)
+                {
+                    const std::int64_t r = hot(v);
+                    if (r != v * 2 + 1 && r != v * 2 + 3)
+                    {
+                        bad.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    calls.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+    }
+    while (calls.load() < 1000)
+    {
+        std::this_thread::yield();
+    }
+
+    const LivePatchStats before = GetLivePatchStats();
+    bool switched = true;
+    for (int i = 0; i < kSwitches; ++i)
+    {
+        switched = SetDecoratorBypass<&Hot>(true) && switched;
+        switched = SetDecoratorBypass<&Hot>(false) && switched;
+    }
+    const LivePatchStats after = GetLivePatchStats();
+    Expect(switched, "every switch succeeded");
+    Expect((after.pauses - before.pauses) - (after.retries - before.retries) == 2 * kSwitches, "one pause per switch");
+    Expect(after.failures == before.failures, "no refused write");
+    Expect(after.last_threads >= kWorkers, "workers parked");
+    Expect(after.max_pause_ns > 0 && after.total_pause_ns >= after.max_pause_ns, "pauses measured");
+
+    // A thread that never takes the stop signal: the write is refused.
+    std::atomic<bool> blocked_ready{ false };
+    std::atomic<bool> blocked_done{ false };
+    std::thread blocked([&]()
+        {
+            sigset_t all{};
+            sigfillset(&all);
+            pthread_sigmask(SIG_BLOCK, &all, nullptr);
+            blocked_ready.store(true);
+            while (!blocked_done.load())
+            {
+                std::this_thread::yield();
+            }
+        });
+    while (!blocked_ready.load())
+    {
+        std::this_thread::yield();
+    }
+    Expect(!SetDecoratorBypass<&Hot>(true), "write refused while a thread blocks the signal");
+    Expect(GetLivePatchStats().failures == after.failures + 1, "refusal counted");
+    blocked_done.store(true);
+    blocked.join();
+
+    Expect(SetDecoratorBypass<&Hot>(false), "switch after the blocking thread left");
+    stop.store(true);
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    Expect(bad.load() == 0, "workers only saw original or decorated results");
+
+    std::int64_t(*volatile hot)(std::int64_t) = &Hot;
+    Expect(hot(1) == 5, "decorated after the last switch");
+
+    return Finish("live patching ok: max pause ", after.max_pause_ns, " ns avg ", (after.pauses != 0 ? after.total_pause_ns / after.pauses : 0), " retries ", after.retries);
+}
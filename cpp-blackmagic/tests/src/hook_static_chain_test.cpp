@@ -0,0 +1,306 @@
+// Static (fused) decorator chains: call order, rejection, per-decorator
+// contexts, a runtime decorator on the same target next to the chain, and
+// installation while a call is in flight.
+#include <cppbm/decorator.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "expect.h"
+
+using namespace cpp::blackmagic;
+
+namespace
+{
+    std::string g_log{};
+    int g_original_calls = 0;
+    bool g_contexts_aligned = true;
+    std::atomic<bool> g_held_entered{ false };
+    std::atomic<bool> g_held_release{ false };
+
+    bool Aligned(const void* p, std::size_t align)
+    {
+        return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+    }
+
+    // Out of line: an inlined string append would open the hooked targets
+    // with an instruction the backend cannot relocate.
+    [[gnu::noinline]] void Trace(const std::string& text)
+    {
+        ++g_original_calls;
+        g_log += text;
+    }
+}
+
+int Sum(int v)
+{
+    Trace("call ");
+    return v + 100;
+}
+
+void Touch(int v)
+{
+    Trace("call" + std::to_string(v) + " ");
+}
+
+// Logs "<name>< " before and "<name>> " after; adds `Add` to the argument.
+template <char Name, int Add>
+struct Tag
+{
+    template <auto Target>
+    class Decorator : public FunctionDecorator<Target>
+    {
+    public:
+        using FunctionDecorator<Target>::BeforeCall;
+        using FunctionDecorator<Target>::AfterCall;
+
+        bool BeforeCall(int& v) override
+        {
+            g_log += std::string(1, Name) + "< ";
+            v += Add;
+            return true;
+        }
+
+        void AfterCall(int& result) override
+        {
+            g_log += std::string(1, Name) + "> ";
+            result += Add;
+        }
+    };
+};
+
+// Rejects negative arguments and supplies the result itself.
+template <auto Target>
+class Reject : public FunctionDecorator<Target>
+{
+public:
+    using FunctionDecorator<Target>::BeforeCall;
+    using FunctionDecorator<Target>::AfterCall;
+
+    bool BeforeCall(int& v) override
+    {
+        g_log += "r< ";
+        rejected_ = v < 0;
+        return !rejected_;
+    }
+
+    void AfterCall(int& result) override
+    {
+        g_log += "r> ";
+        if (rejected_)
+        {
+            result = -1;
+        }
+    }
+
+private:
+    bool rejected_ = false;
+};
+
+// Per-call context with a stricter alignment than its size implies.
+template <std::size_t Align, char Name>
+struct AlignedState
+{
+    template <auto Target>
+    class Decorator : public FunctionDecorator<Target>
+    {
+    public:
+        struct alignas(Align) State
+        {
+            int seen = 0;
+        };
+
+        std::size_t ContextSize() const override
+        {
+            return sizeof(State);
+        }
+
+        std::size_t ContextAlign() const override
+        {
+            return Align;
+        }
+
+        bool BeforeCall(hook::CallContext& ctx, int& v) override
+        {
+            State* state = ctx.As<State>();
+            g_contexts_aligned = g_contexts_aligned && state != nullptr && Aligned(state, Align);
+            if (state != nullptr)
+            {
+                state->seen = v * 10 + (Name - 'a');
+            }
+            return true;
+        }
+
+        void AfterCall(hook::CallContext& ctx, int& result) override
+        {
+            const State* state = ctx.As<State>();
+            g_contexts_aligned = g_contexts_aligned && state != nullptr && Aligned(state, Align);
+            if (state != nullptr)
+            {
+                result = state->seen;
+            }
+        }
+    };
+};
+
+template <auto Target>
+class VoidTag : public FunctionDecorator<Target>
+{
+public:
+    using FunctionDecorator<Target>::BeforeCall;
+    using FunctionDecorator<Target>::AfterCall;
+
+    bool BeforeCall(int& v) override
+    {
+        g_log += "v< ";
+        return v != 0;
+    }
+
+    void AfterCall() override
+    {
+        g_log += "v> ";
+    }
+};
+
+// Attached at runtime through the dynamic pipeline.
+template <auto Target>
+class Runtime : public FunctionDecorator<Target>
+{
+public:
+    bool BeforeCall(int& /*v*/) override
+    {
+        g_log += "R< ";
+        return true;
+    }
+
+    void AfterCall(int& /*result*/) override
+    {
+        g_log += "R> ";
+    }
+};
+
+int Ctx(int v)
+{
+    Trace("ctx ");
+    return v;
+}
+
+// Blocks until released; the hooked call holds its read section meanwhile.
+int Held(int v)
+{
+    g_held_entered.store(true);
+    while (!g_held_release.load())
+    {
+        std::this_thread::yield();
+    }
+    return v;
+}
+
+template <template <auto> class D>
+inline constexpr DecoratorBinder<D> binder{};
+
+inline auto sum_chain = BindStaticChain<&Sum>(
+    binder<Tag<'a', 1>::Decorator>.BindStatic<&Sum>(),
+    binder<Reject>.BindStatic<&Sum>(),
+    binder<Tag<'b', 10>::Decorator>.BindStatic<&Sum>());
+
+inline auto touch_chain = BindStaticChain<&Touch>(
+    binder<VoidTag>.BindStatic<&Touch>());
+
+inline auto ctx_chain = BindStaticChain<&Ctx>(
+    binder<AlignedState<64, 'a'>::Decorator>.BindStatic<&Ctx>(),
+    binder<AlignedState<16, 'b'>::Decorator>.BindStatic<&Ctx>());
+
+// Each callback of these decorators binds to its concrete override at
+// compile time (a qualified call the compiler can inline), not a vtable slot.
+using SumCall = hook::StaticNodeCall<hook::DecoratorNode<int, int>>;
+static_assert(SumCall::CtxBeforeStep<Tag<'a', 1>::Decorator<&Sum>>() == hook::StaticStep::Inherited);
+static_assert(SumCall::CtxAfterStep<Reject<&Sum>>() == hook::StaticStep::Inherited);
+static_assert(SumCall::CtxBeforeStep<AlignedState<64, 'a'>::Decorator<&Ctx>>() == hook::StaticStep::Overridden);
+static_assert(SumCall::SlotBeforeStep<Reject<&Sum>>() == hook::StaticStep::Inherited);
+// Hiding the context overload (no using-declaration) is classified as such
+// and falls back to the virtual call; BindStaticChain rejects the decorator.
+static_assert(SumCall::CtxBeforeStep<Runtime<&Sum>>() == hook::StaticStep::Hidden);
+static_assert(!SumCall::BindsStatically<Runtime<&Sum>>());
+static_assert(SumCall::BindsStatically<Tag<'a', 1>::Decorator<&Sum>>());
+using TouchCall = hook::StaticNodeCall<hook::DecoratorNode<void, int>>;
+static_assert(TouchCall::CtxAfterStep<VoidTag<&Touch>>() == hook::StaticStep::Inherited);
+
+int main()
+{
+    // Failures also print the call log.
+    g_failure_context = &g_log;
+
+    int(*volatile sum)(int) = &Sum;
+    void(*volatile touch)(int) = &Touch;
+    int(*volatile ctx)(int) = &Ctx;
+
+    // Before in declaration order, After in reverse.
+    g_log.clear();
+    Expect(sum(1) == 1 + 1 + 10 + 100 + 10 + 1, "arguments and results threaded through the chain");
+    Expect(g_log == "a< r< b< call b> r> a> ", "before/after order across fused decorators");
+
+    // Rejection stops the walk; only invoked decorators get After.
+    g_log.clear();
+    g_original_calls = 0;
+    Expect(sum(-5) == -1 + 1, "rejecting decorator supplies the result");
+    Expect(g_log == "a< r< r> a> ", "rejection short-circuits the rest of the chain");
+    Expect(g_original_calls == 0, "original skipped on rejection");
+
+    // void target.
+    g_log.clear();
+    touch(3);
+    touch(0);
+    Expect(g_log == "v< call3 v> v< v> ", "void chain, with and without rejection");
+
+    // Each decorator gets its own slice at its own alignment.
+    Expect(ctx(4) == 40, "outer context survives the inner decorator");
+    Expect(g_contexts_aligned, "each context slice honours its decorator's alignment");
+
+    // A runtime decorator joins the dynamic pipeline after the fused node.
+    {
+        g_log.clear();
+        Runtime<&Sum> runtime{};
+        Expect(sum(1) == 123, "runtime decorator keeps results");
+        Expect(g_log == "a< r< b< R< call R> b> r> a> ", "runtime decorator runs inside the fused chain");
+    }
+    g_log.clear();
+    Expect(sum(1) == 123, "chain alone after the runtime decorator left");
+    Expect(g_log == "a< r< b< call b> r> a> ", "runtime decorator removed");
+
+    // The chain registers as one node and its members never register on
+    // their own, so installing it does not wait for a call in flight.
+    {
+        using namespace std::chrono_literals;
+        using HeldChain = StaticDecoratorBinding<&Held, Tag<'h', 0>::Decorator<&Held>>;
+
+        int(*volatile held)(int) = &Held;
+        Runtime<&Held> runtime{};
+        g_log.clear();
+        std::thread caller([&]() { (void)held(1); });
+        while (!g_held_entered.load())
+        {
+            std::this_thread::yield();
+        }
+
+        std::optional<HeldChain> chain{};
+        auto installed = std::async(std::launch::async, [&]() { chain.emplace(); });
+        Expect(installed.wait_for(2s) == std::future_status::ready, "chain installs while a call is in flight");
+
+        g_held_release.store(true);
+        caller.join();
+        installed.wait();
+        g_log.clear();
+        Expect(held(2) == 2, "chain on a target with a runtime decorator");
+        Expect(g_log == "R< h< h> R> ", "chain joins after the runtime decorator");
+    }
+
+    return Finish("static chain ok");
+}
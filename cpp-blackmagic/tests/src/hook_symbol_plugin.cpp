@@ -0,0 +1,17 @@
+// Plugin for cppbm-test-hook-symbol: never linked, only dlopen()ed.
+#include <cstdint>
+
+extern "C" std::int64_t PluginWork(std::int64_t v)
+{
+    return (v ^ 0x33) + 5;
+}
+
+extern "C" std::int64_t PluginAux(std::int64_t v)
+{
+    return v * 3 + 1;
+}
+
+extern "C" std::int64_t PluginThird(std::int64_t v)
+{
+    return v - 100;
+}
@@ -0,0 +1,109 @@
+// Runtime symbol targets: decorators registered by library/symbol name before
+// the plugin is loaded, installed once dlopen() maps it.
+#include <cppbm/decorator.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <dlfcn.h>
+#include <iostream>
+
+#include "expect.h"
+
+using namespace cpp::blackmagic;
+
+namespace
+{
+    using Fn = std::int64_t(*)(std::int64_t);
+
+    std::size_t g_before_calls = 0;
+
+    std::int64_t Work(std::int64_t v)
+    {
+        return (v ^ 0x33) + 5;
+    }
+}
+
+class WorkTiming : public SymbolDecorator<std::int64_t(std::int64_t)>
+{
+public:
+    WorkTiming()
+        : SymbolDecorator(CPPBM_SYMBOL_PLUGIN_LIBRARY, "PluginWork")
+    {
+    }
+
+    bool BeforeCall(std::int64_t& v) override
+    {
+        ++g_before_calls;
+        v += 1;
+        return true;
+    }
+
+    void AfterCall(std::int64_t& result) override
+    {
+        Expect(CallOriginal(0) == Work(0), "CallOriginal reaches the plugin");
+        result += 1000;
+    }
+};
+
+class AuxCount : public SymbolDecorator<std::int64_t(std::int64_t)>
+{
+public:
+    AuxCount()
+        : SymbolDecorator(CPPBM_SYMBOL_PLUGIN_LIBRARY, "PluginAux")
+    {
+    }
+
+    bool BeforeCall(std::int64_t&) override
+    {
+        ++g_before_calls;
+        return true;
+    }
+};
+
+int main()
+{
+    hook::SetHookFailPolicy(hook::HookFailPolicy::Ignore);
+
+    WorkTiming timing{};
+    Expect(timing.GetPipeline() != nullptr, "pipeline created");
+    Expect(timing.GetPipeline()->State() == HookPipelineState::Registered, "recorded before the plugin is loaded");
+    Expect(hook::SymbolTargets::GetInstance().Pending() == 1, "one pending target");
+
+    void* plugin = dlopen(CPPBM_SYMBOL_PLUGIN_LIBRARY, RTLD_NOW | RTLD_LOCAL);
+    Expect(plugin != nullptr, "plugin loaded");
+    if (plugin == nullptr)
+    {
+        return 1;
+    }
+
+    // The dlopen() interception resolved and installed it.
+    Expect(hook::SymbolTargets::GetInstance().Pending() == 0, "resolved on load");
+    Expect(timing.GetPipeline()->State() == HookPipelineState::Installed, "installed on load");
+
+    auto work = reinterpret_cast<Fn>(dlsym(plugin, "PluginWork"));
+    Expect(work(1) == Work(2) + 1000, "plugin call decorated");
+    Expect(g_before_calls == 1, "decorator ran once");
+
+    // Library already loaded: resolved and installed at registration.
+    {
+        AuxCount aux{};
+        Expect(aux.GetPipeline()->State() == HookPipelineState::Installed, "installed at registration");
+        auto aux_fn = reinterpret_cast<Fn>(dlsym(plugin, "PluginAux"));
+        Expect(aux_fn(2) == 7, "aux call result");
+        Expect(g_before_calls == 2, "aux decorator ran");
+    }
+
+    // Same (library, symbol, signature): same pipeline.
+    {
+        WorkTiming second{};
+        Expect(second.GetPipeline() == timing.GetPipeline(), "pipeline shared");
+    }
+
+    // Pool of this test: CPPBM_HOOK_SYMBOL_SLOTS=2 (PluginWork, PluginAux).
+    auto* third = hook::SymbolPipelines<std::int64_t, std::int64_t>::Get(CPPBM_SYMBOL_PLUGIN_LIBRARY, "PluginThird");
+    Expect(third == nullptr, "pool exhausted");
+    const auto error = hook::GetLastHookError();
+    Expect(error.has_value() && error->code == hook::HookErrorCode::DetourPoolExhausted, "exhaustion reported");
+
+    return Finish("symbol targets ok");
+}
@@ -0,0 +1,119 @@
+// Vtable-slot hooks: a virtual member is decorated per class by swapping one
+// slot of that class's vtable; other classes sharing the implementation and
+// the code itself are left alone.
+#include <cppbm/decorator.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include "expect.h"
+
+using namespace cpp::blackmagic;
+
+namespace
+{
+    std::size_t g_before_calls = 0;
+}
+
+class Shape
+{
+public:
+    virtual ~Shape() = default;
+    virtual std::int64_t Area(std::int64_t scale) const { return scale; }
+    virtual std::int64_t Sides() const { return 0; }
+};
+
+class Square : public Shape
+{
+public:
+    std::int64_t Area(std::int64_t scale) const override { return 4 * scale; }
+    std::int64_t Sides() const override { return 4; }
+};
+
+class Circle : public Shape
+{
+public:
+    std::int64_t Area(std::int64_t scale) const override { return 3 * scale; }
+};
+
+// Does not override Area: shares Shape::Area's code, not Shape's vtable.
+class Blob : public Shape
+{
+};
+
+// Opaque to the optimizer, so every call goes through the vtable.
+[[gnu::noinline]] std::int64_t CallArea(const Shape& shape, std::int64_t scale)
+{
+    return shape.Area(scale);
+}
+
+class SquareArea : public FunctionDecorator<&Square::Area>
+{
+public:
+    bool BeforeCall(const Square*&, std::int64_t& scale) override
+    {
+        ++g_before_calls;
+        scale += 1;
+        return true;
+    }
+
+    void AfterCall(std::int64_t& result) override
+    {
+        result += 1000;
+    }
+};
+
+class ShapeArea : public FunctionDecorator<&Shape::Area>
+{
+public:
+    bool BeforeCall(const Shape*& self, std::int64_t& scale) override
+    {
+        ++g_before_calls;
+        // `this` arrives exactly as the caller passed it.
+        Expect(CallOriginal(self, 2) == 2, "CallOriginal reaches Shape::Area");
+        scale *= 10;
+        return true;
+    }
+};
+
+int main()
+{
+    Square square{};
+    Circle circle{};
+    Blob blob{};
+    Shape shape{};
+
+    // Code bytes of the shared implementation must never change.
+    unsigned char code[16]{};
+    void* shape_area_slot = (*reinterpret_cast<void***>(&shape))[2];
+    std::memcpy(code, shape_area_slot, sizeof(code));
+
+    {
+        SquareArea decorator{};
+        Expect(GetDecoratorState<&Square::Area>() == HookPipelineState::Installed, "installed");
+        Expect(CallArea(square, 1) == 4 * 2 + 1000, "square call decorated");
+        Expect(CallArea(circle, 1) == 3, "other override untouched");
+        Expect(square.Sides() == 4, "other slot untouched");
+        Expect(g_before_calls == 1, "decorator ran once");
+
+        Expect(SetDecoratorBypass<&Square::Area>(true), "bypass succeeds");
+        Expect(CallArea(square, 1) == 4, "bypassed: slot restored");
+        Expect(SetDecoratorBypass<&Square::Area>(false), "resume succeeds");
+        Expect(CallArea(square, 1) == 4 * 2 + 1000, "resumed");
+    }
+    Expect(CallArea(square, 1) == 4, "unregistered decorator no longer runs");
+
+    g_before_calls = 0;
+    {
+        ShapeArea decorator{};
+        Expect(CallArea(shape, 1) == 10, "Shape's own vtable decorated");
+        Expect(CallArea(blob, 1) == 1, "same implementation through Blob's vtable untouched");
+        Expect(g_before_calls == 1, "shape decorator ran once");
+    }
+
+    Expect(std::memcmp(code, shape_area_slot, sizeof(code)) == 0, "implementation code not patched");
+
+    return Finish("vtable ok");
+}
@@ -0,0 +1,166 @@
+// Install time and per-call overhead: native x86-64 hooker vs Dobby.
+// The native hooker is measured twice: one enable per hook, and queued enables
+// applied in a single ApplyQueued() pass.
+// Both backends are linked directly (not through Hooker::GetInstance), each
+// hooking its own set of otherwise identical target functions.
+#include "internal/hooker/native_x86_64.h"
+
+#include <Dobby/Dobby.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+
+using namespace cpp::blackmagic;
+
+namespace
+{
+    using Fn = std::int64_t(*)(std::int64_t);
+
+    // Prevent optimizer from removing benchmark work.
+    volatile std::int64_t g_sink = 0;
+
+    constexpr std::size_t kTargets = 128;
+
+    enum Set : int
+    {
+        kPlainSet = 0,
+        kNativeSet = 1,
+        kDobbySet = 2,
+        kNativeBatchSet = 3,
+    };
+
+    template <int S>
+    std::array<Fn, kTargets> g_original{};
+}
+
+// Distinct bodies per (set, index), so no two targets share code.
+template <int S, std::size_t I>
+std::int64_t Target(std::int64_t v)
+{
+    return (v ^ static_cast<std::int64_t>(0x1000 + I)) + S;
+}
+
+template <int S, std::size_t I>
+std::int64_t Detour(std::int64_t v)
+{
+    return g_original<S>[I](v);
+}
+
+template <int S, std::size_t... I>
+constexpr std::array<Fn, kTargets> MakeTargets(std::index_sequence<I...>)
+{
+    return { &Target<S, I>... };
+}
+
+template <int S, std::size_t... I>
+constexpr std::array<Fn, kTargets> MakeDetours(std::index_sequence<I...>)
+{
+    return { &Detour<S, I>... };
+}
+
+template <int S>
+const std::array<Fn, kTargets> kTargetFns = MakeTargets<S>(std::make_index_sequence<kTargets>{});
+
+template <int S>
+const std::array<Fn, kTargets> kDetourFns = MakeDetours<S>(std::make_index_sequence<kTargets>{});
+
+template <typename InstallFn>
+double InstallAll(InstallFn&& install)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto beg = Clock::now();
+    for (std::size_t i = 0; i < kTargets; ++i)
+    {
+        if (!install(i))
+        {
+            std::cerr << "install failed at target " << i << std::endl;
+            return -1.0;
+        }
+    }
+    const auto end = Clock::now();
+    return std::chrono::duration<double, std::micro>(end - beg).count() / kTargets;
+}
+
+double NsPerCall(Fn fn, int calls)
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Call through a volatile pointer so the compiler cannot bypass the hooked entry.
+    std::int64_t(*volatile entry)(std::int64_t) = fn;
+    std::int64_t acc = 0;
+
+    const auto beg = Clock::now();
+    for (int i = 0; i < calls; ++i)
+    {
+        acc += entry(i);
+    }
+    const auto end = Clock::now();
+
+    // GCC C++20 warns on compound assignment with volatile lvalue.
+    const std::int64_t sink_snapshot = g_sink;
+    g_sink = sink_snapshot + acc;
+    return std::chrono::duration<double, std::nano>(end - beg).count() / calls;
+}
+
+int main()
+{
+    constexpr int kCalls = 20000000;
+
+    hook::NativeX86_64Hooker native{};
+    const double native_us = InstallAll([&native](std::size_t i)
+        {
+            void* target = reinterpret_cast<void*>(kTargetFns<kNativeSet>[i]);
+            void** origin = reinterpret_cast<void**>(&g_original<kNativeSet>[i]);
+            return native.CreateHook(target, reinterpret_cast<void*>(kDetourFns<kNativeSet>[i]), origin) &&
+                native.EnableHook(target);
+        });
+
+    hook::NativeX86_64Hooker native_batch{};
+    const double native_batch_us = InstallAll([&native_batch](std::size_t i)
+        {
+            void* target = reinterpret_cast<void*>(kTargetFns<kNativeBatchSet>[i]);
+            void** origin = reinterpret_cast<void**>(&g_original<kNativeBatchSet>[i]);
+            const bool queued = native_batch.CreateHook(target, reinterpret_cast<void*>(kDetourFns<kNativeBatchSet>[i]), origin) &&
+                native_batch.QueueEnableHook(target);
+            return queued && (i + 1 < kTargets || native_batch.ApplyQueued());
+        });
+
+    const double dobby_us = InstallAll([](std::size_t i)
+        {
+            void* target = reinterpret_cast<void*>(kTargetFns<kDobbySet>[i]);
+            void** origin = reinterpret_cast<void**>(&g_original<kDobbySet>[i]);
+            return DobbyHook(target, reinterpret_cast<void*>(kDetourFns<kDobbySet>[i]), origin) == 0;
+        });
+
+    std::cout << "Install time (" << kTargets << " targets)" << std::endl;
+    std::cout << std::fixed << std::setprecision(2)
+              << "native  " << native_us << " us/hook" << std::endl
+              << "batched " << native_batch_us << " us/hook" << std::endl
+              << "dobby   " << dobby_us << " us/hook" << std::endl;
+
+    // Warm up caches and branch predictors on every path first.
+    (void)NsPerCall(kTargetFns<kPlainSet>[0], 100000);
+    (void)NsPerCall(kTargetFns<kNativeSet>[0], 100000);
+    (void)NsPerCall(kTargetFns<kDobbySet>[0], 100000);
+    (void)NsPerCall(kTargetFns<kNativeBatchSet>[0], 100000);
+
+    const double plain_ns = NsPerCall(kTargetFns<kPlainSet>[0], kCalls);
+    const double native_ns = NsPerCall(kTargetFns<kNativeSet>[0], kCalls);
+    const double dobby_ns = NsPerCall(kTargetFns<kDobbySet>[0], kCalls);
+    const double batch_ns = NsPerCall(kTargetFns<kNativeBatchSet>[0], kCalls);
+
+    std::cout << "Per-call latency (detour -> trampoline -> original, " << kCalls << " calls)" << std::endl;
+    std::cout << std::setprecision(3)
+              << "plain   " << plain_ns << " ns" << std::endl
+              << "native  " << native_ns << " ns (+" << (native_ns - plain_ns) << ")" << std::endl
+              << "dobby   " << dobby_ns << " ns (+" << (dobby_ns - plain_ns) << ")" << std::endl
+              << "batched " << batch_ns << " ns (+" << (batch_ns - plain_ns) << ")" << std::endl;
+
+    std::cout << "Sink: " << g_sink << std::endl;
+    return 0;
+}
@@ -0,0 +1,141 @@
+// Prologue relocation cases for the native x86-64 hooker.
+// Each case is hand-assembled machine code, so the tested encodings do not
+// depend on what the compiler happens to emit.
+#include "internal/hooker/native_x86_64.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sys/mman.h>
+
+#include "expect.h"
+
+using namespace cpp::blackmagic;
+
+namespace
+{
+    using Fn = std::int64_t(*)(std::int64_t);
+
+    Fn g_original = nullptr;
+
+    void Expect(bool condition, const char* name, const char* what)
+    {
+        if (!condition)
+        {
+            std::cerr << "FAILED [" << name << "]: " << what << std::endl;
+            ++g_failures;
+        }
+    }
+
+    std::int64_t Detour(std::int64_t v)
+    {
+        return g_original(v) + 1000;
+    }
+
+    struct Case
+    {
+        const char* name;
+        std::size_t size;
+        unsigned char code[48];
+        std::int64_t input;
+        std::int64_t expected;
+        bool hookable;
+    };
+
+    // One page per case: code at offset 0, data (for RIP-relative loads) at 64.
+    unsigned char* Materialize(const Case& c)
+    {
+        void* mem = mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        auto* page = static_cast<unsigned char*>(mem);
+        std::memset(page, 0xCC, 4096);
+        std::memcpy(page, c.code, c.size);
+        const std::int64_t data = 40;
+        std::memcpy(page + 64, &data, sizeof(data));
+        mprotect(mem, 4096, PROT_READ | PROT_EXEC);
+        return page;
+    }
+
+    void Run(hook::NativeX86_64Hooker& hooker, const Case& c)
+    {
+        unsigned char* code = Materialize(c);
+        Expect(code != nullptr, c.name, "mmap");
+        if (code == nullptr)
+        {
+            return;
+        }
+        Fn fn = reinterpret_cast<Fn>(code);
+        Expect(fn(c.input) == c.expected, c.name, "unhooked result");
+
+        void* original = nullptr;
+        const bool created = hooker.CreateHook(code, reinterpret_cast<void*>(&Detour), &original);
+        Expect(created == c.hookable, c.name, c.hookable ? "CreateHook accepted" : "CreateHook rejected");
+        if (!created)
+        {
+            return;
+        }
+        g_original = reinterpret_cast<Fn>(original);
+
+        Expect(fn(c.input) == c.expected, c.name, "created but not enabled");
+        Expect(hooker.EnableHook(code), c.name, "EnableHook");
+        Expect(fn(c.input) == c.expected + 1000, c.name, "hooked result via trampoline");
+        Expect(hooker.DisableHook(code), c.name, "DisableHook");
+        Expect(fn(c.input) == c.expected, c.name, "disabled result");
+        Expect(hooker.EnableHook(code), c.name, "re-EnableHook");
+        Expect(fn(c.input) == c.expected + 1000, c.name, "re-enabled result");
+        Expect(hooker.RemoveHook(code), c.name, "RemoveHook");
+        Expect(fn(c.input) == c.expected, c.name, "removed result");
+    }
+}
+
+int main()
+{
+    const Case cases[] = {
+        // mov rax, [rip+57] (-> offset 64); add rax, rdi; ret
+        { "rip-relative", 11,
+            { 0x48, 0x8B, 0x05, 0x39, 0x00, 0x00, 0x00, 0x48, 0x01, 0xF8, 0xC3 },
+            2, 42, true },
+        // test rdi, rdi; je +4; mov rax, rdi; ret; mov rax, 42; ret
+        { "jcc-rel8", 17,
+            { 0x48, 0x85, 0xFF, 0x74, 0x04, 0x48, 0x89, 0xF8, 0xC3,
+              0x48, 0xC7, 0xC0, 0x2A, 0x00, 0x00, 0x00, 0xC3 },
+            0, 42, true },
+        // call +4 (-> helper); add rax, rdi; ret; helper: mov rax, 100; ret
+        { "call-rel32", 17,
+            { 0xE8, 0x04, 0x00, 0x00, 0x00, 0x48, 0x01, 0xF8, 0xC3,
+              0x48, 0xC7, 0xC0, 0x64, 0x00, 0x00, 0x00, 0xC3 },
+            5, 105, true },
+        // mov eax, edi; ret; int3 padding covers the rest of the patch
+        { "short-padded", 3,
+            { 0x89, 0xF8, 0xC3 },
+            9, 9, true },
+        // endbr64; lea rax, [rdi+3]; ret
+        { "endbr64", 9,
+            { 0xF3, 0x0F, 0x1E, 0xFA, 0x48, 0x8D, 0x47, 0x03, 0xC3 },
+            4, 7, true },
+        // mov rax, rdi; jmp +1; int3; add rax, 2; ret
+        // (jmp ends the prologue; its target lies past the patch)
+        { "jmp-rel8", 11,
+            { 0x48, 0x89, 0xF8, 0xEB, 0x01, 0xCC, 0x48, 0x83, 0xC0, 0x02, 0xC3 },
+            1, 3, true },
+        // xor ecx, ecx; jrcxz +0; mov rax, rdi; ret  (jrcxz cannot be relocated)
+        { "jrcxz-rel8", 8,
+            { 0x31, 0xC9, 0xE3, 0x00, 0x48, 0x89, 0xF8, 0xC3 },
+            3, 3, false },
+        // mov eax, edi; loop: dec eax; jne loop; ret  (branch back into the patch)
+        { "branch-into-patch", 7,
+            { 0x89, 0xF8, 0xFF, 0xC8, 0x75, 0xFC, 0xC3 },
+            3, 0, false },
+    };
+
+    hook::NativeX86_64Hooker hooker{};
+    for (const Case& c : cases)
+    {
+        Run(hooker, c);
+    }
+
+    return Finish("native hooker relocation cases ok");
+}
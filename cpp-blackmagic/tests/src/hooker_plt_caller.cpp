@@ -0,0 +1,10 @@
+// Shared library for cppbm-test-hooker-plt: dlopen()ed after the hook is
+// enabled, imports CppbmPltTarget through its own PLT.
+#include <cstdint>
+
+extern "C" std::int64_t CppbmPltTarget(std::int64_t v);
+
+extern "C" __attribute__((visibility("default"))) std::int64_t CppbmPltCaller(std::int64_t v)
+{
+    return CppbmPltTarget(v);
+}
@@ -0,0 +1,7 @@
+// Shared library for cppbm-test-hooker-plt: the hooked export.
+#include <cstdint>
+
+extern "C" __attribute__((visibility("default"), noinline)) std::int64_t CppbmPltTarget(std::int64_t v)
+{
+    return (v ^ 0x77) + 7;
+}
@@ -0,0 +1,96 @@
+// PLT/GOT hooker: redirects an imported export in the executable and in a
+// library dlopen()ed after the hook was enabled.
+#include "internal/hooker/plt.h"
+
+#include <cstdint>
+#include <dlfcn.h>
+#include <iostream>
+
+#include "expect.h"
+
+using namespace cpp::blackmagic;
+
+extern "C" std::int64_t CppbmPltTarget(std::int64_t v);
+
+namespace
+{
+    using Fn = std::int64_t(*)(std::int64_t);
+
+    Fn g_original = nullptr;
+
+    std::int64_t Detour(std::int64_t v)
+    {
+        return g_original(v) + 1000;
+    }
+
+    std::int64_t Expected(std::int64_t v)
+    {
+        return (v ^ 0x77) + 7;
+    }
+}
+
+int main()
+{
+    hook::PltHooker hooker{};
+
+    // The definition's address; &CppbmPltTarget may be a PLT stub in a non-PIE build.
+    void* target = dlsym(RTLD_DEFAULT, "CppbmPltTarget");
+    Expect(target != nullptr, "target resolved");
+    if (target == nullptr)
+    {
+        return 1;
+    }
+
+    int local = 0;
+    void* unused = nullptr;
+    Expect(!hooker.CreateHook(&local, reinterpret_cast<void*>(&Detour), &unused), "non-symbol target rejected");
+
+    void* original = nullptr;
+    Expect(hooker.CreateHook(target, reinterpret_cast<void*>(&Detour), &original), "CreateHook");
+    Expect(original == target, "original is the target itself");
+    g_original = reinterpret_cast<Fn>(original);
+
+    Expect(CppbmPltTarget(1) == Expected(1), "created but not enabled");
+    Expect(hooker.EnableHook(target), "EnableHook");
+    Expect(hooker.PatchedSlots(target) >= 1, "executable slot patched");
+    Expect(CppbmPltTarget(1) == Expected(1) + 1000, "executable call redirected");
+
+    // Loaded after the hook: picked up by the dlopen() re-scan.
+    void* caller_lib = dlopen(CPPBM_PLT_CALLER_LIBRARY, RTLD_NOW | RTLD_LOCAL);
+    Expect(caller_lib != nullptr, "caller library loaded");
+    if (caller_lib != nullptr)
+    {
+        auto caller = reinterpret_cast<Fn>(dlsym(caller_lib, "CppbmPltCaller"));
+        Expect(caller != nullptr, "caller resolved");
+        Expect(caller(2) == Expected(2) + 1000, "late-loaded library call redirected");
+
+        // Nothing imports CppbmPltCaller: a non-owner cannot enable it, the
+        // owner keeps it pending for a later dlopen().
+        void* unimported = dlsym(caller_lib, "CppbmPltCaller");
+        hook::PltHooker other{};
+        void* other_original = nullptr;
+        Expect(other.CreateHook(unimported, reinterpret_cast<void*>(&Detour), &other_original), "second instance CreateHook");
+        Expect(!other.EnableHook(unimported), "unpatched hook rejected without dlopen re-scan");
+        Expect(other.RemoveHook(unimported), "second instance RemoveHook");
+        Expect(hooker.CreateHook(unimported, reinterpret_cast<void*>(&Detour), &other_original), "owner CreateHook");
+        Expect(hooker.EnableHook(unimported), "owner keeps unpatched hook pending");
+        Expect(hooker.PatchedSlots(unimported) == 0, "pending hook patched nothing");
+        Expect(hooker.RemoveHook(unimported), "owner RemoveHook");
+
+        Expect(hooker.DisableHook(target), "DisableHook");
+        Expect(hooker.PatchedSlots(target) == 0, "slots restored");
+        Expect(CppbmPltTarget(3) == Expected(3), "executable call restored");
+        Expect(caller(3) == Expected(3), "library call restored");
+
+        Expect(hooker.EnableHook(target), "re-EnableHook");
+        Expect(caller(4) == Expected(4) + 1000, "library call redirected again");
+
+        // Unload while enabled: removal must skip the stale slot.
+        dlclose(caller_lib);
+    }
+
+    Expect(hooker.RemoveHook(target), "RemoveHook");
+    Expect(CppbmPltTarget(5) == Expected(5), "removed");
+
+    return Finish("plt hooker ok");
+}